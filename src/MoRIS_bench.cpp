@@ -0,0 +1,989 @@
+/**
+ * \file      MoRIS_bench.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     MoRIS_bench executable
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "../cmake/Config.h"
+
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <sys/resource.h>
+#include <time.h>
+#include <assert.h>
+
+#include "./lib/Parameters.h"
+#include "./lib/Simulation.h"
+#include "./lib/Landscape.h"
+#include "./lib/TextWriter.h"
+
+void printUsage( void );
+void readArgs( int argc, char const** argv, std::vector<std::string>& names, std::vector<std::string>& values, std::vector<int>& sizes, std::vector<int>& reps, std::vector<std::string>& laws, std::vector<int>& threads, int& nb_runs, int& nb_iterations, int& nb_repeats, std::string& folder, std::string& output_filename, std::string& baseline_filename, double& tolerance );
+std::vector<std::string> splitList( std::string option, std::string text );
+std::vector<int> parseSizes( std::string option, std::string text );
+Parameters* buildParameters( const std::vector<std::string>& names, const std::vector<std::string>& values, int nb_iterations );
+int writeLattice( Parameters* parameters, int size, std::string folder );
+void setLaw( Parameters* parameters, std::string law, const std::vector<std::string>& names, const std::vector<std::string>& values );
+void benchPhases( const std::vector<std::string>& names, const std::vector<std::string>& values, const std::vector<int>& sizes, const std::vector<int>& reps, const std::vector<std::string>& laws, int nb_iterations, int nb_repeats, std::string folder, std::string output_filename );
+void benchScaling( const std::vector<std::string>& names, const std::vector<std::string>& values, const std::vector<int>& sizes, const std::vector<int>& reps, std::string law, const std::vector<int>& threads, int nb_runs, int nb_iterations, std::string folder, std::string output_filename );
+void runScalingWorker( Simulation* simulation, Parameters* parameters, unsigned long int seed, std::atomic<int>* next_run, int nb_runs );
+int compareToBaseline( std::string output_filename, std::string baseline_filename, double tolerance );
+void readBenchTable( std::string filename, std::vector<std::string>& workloads, std::vector<double>& rel_steps, std::vector<double>& rel_updates );
+void buildCalibrationCycle( std::vector<uint32_t>& cycle );
+double timeCalibration( const std::vector<uint32_t>& cycle );
+void resetPeakRss( void );
+double readPeakRss( void );
+double elapsedSeconds( std::chrono::steady_clock::time_point start );
+double threadCpuSeconds( void );
+
+volatile double calibration_checksum = 0.0; /*!< Result of the calibration loop, kept so that the loop is not optimized out */
+
+/**
+ * \brief    main function
+ * \details  --
+ * \param    int argc
+ * \param    char const** argv
+ * \return   \e int
+ */
+int main(int argc, char const** argv)
+{
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Read command line arguments                     */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<std::string> names;
+  std::vector<std::string> values;
+  std::vector<int>         sizes;
+  std::vector<int>         reps;
+  std::vector<std::string> laws;
+  std::vector<int>         threads;
+  int                      nb_runs           = 0;
+  int                      nb_iterations     = 10;
+  int                      nb_repeats        = 1;
+  std::string              folder            = "bench";
+  std::string              output_filename   = "bench.csv";
+  std::string              baseline_filename = "";
+  double                   tolerance         = 0.25;
+  readArgs(argc, argv, names, values, sizes, reps, laws, threads, nb_runs, nb_iterations, nb_repeats, folder, output_filename, baseline_filename, tolerance);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Run the phase or the scaling benchmark          */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  system(("mkdir -p "+folder).c_str());
+  if (threads.empty())
+  {
+    benchPhases(names, values, sizes, reps, laws, nb_iterations, nb_repeats, folder, output_filename);
+  }
+  else
+  {
+    benchScaling(names, values, sizes, reps, laws[0], threads, nb_runs, nb_iterations, folder, output_filename);
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Compare the throughputs to the baseline         */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  if (baseline_filename != "" && compareToBaseline(output_filename, baseline_filename, tolerance) > 0)
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * \brief    Run the phase benchmark
+ * \details  Times the graph construction, the jumps, the state update and the score, for each lattice size,
+ *           number of repetitions and jump law. The graph is built once by size and number of repetitions.
+ *           Each point is run nb_repeats times with the same seed, and the fastest run is kept. The phases
+ *           are also timed in thread CPU time, and the calibration loop (see timeCalibration()) is run before
+ *           each run. The walk steps and the state updates by calibration loop (rel_steps and rel_updates
+ *           columns, from the fastest CPU times) do not depend on the other processes of the machine, and
+ *           mostly cancel its speed.
+ * \param    const std::vector<std::string>& names
+ * \param    const std::vector<std::string>& values
+ * \param    const std::vector<int>& sizes
+ * \param    const std::vector<int>& reps
+ * \param    const std::vector<std::string>& laws
+ * \param    int nb_iterations
+ * \param    int nb_repeats
+ * \param    std::string folder
+ * \param    std::string output_filename
+ * \return   \e void
+ */
+void benchPhases( const std::vector<std::string>& names, const std::vector<std::string>& values, const std::vector<int>& sizes, const std::vector<int>& reps, const std::vector<std::string>& laws, int nb_iterations, int nb_repeats, std::string folder, std::string output_filename )
+{
+  Parameters*       parameters = buildParameters(names, values, nb_iterations);
+  unsigned long int seed       = parameters->get_prng_seed();
+  TextWriter        output(output_filename);
+  if (!output.is_open())
+  {
+    std::cout << "Error: impossible to write " << output_filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  output << "size,nb_nodes,reps,law,iters,build_s,jumps_s,update_state_s,score_s,jumps,walk_steps,jumps_per_s,steps_per_s,ns_per_node_rep,calibration_cpu_s,rel_steps,rel_updates\n";
+  std::vector<uint32_t> cycle;
+  buildCalibrationCycle(cycle);
+  for (size_t s = 0; s < sizes.size(); s++)
+  {
+    /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+    /* 1) Write the synthetic landscape                   */
+    /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+    int nb_nodes = writeLattice(parameters, sizes[s], folder);
+    
+    for (size_t r = 0; r < reps.size(); r++)
+    {
+      /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+      /* 2) Build the graph                                 */
+      /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+      parameters->set_repetitions(reps[r]);
+      setLaw(parameters, laws[0], names, values);
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      Simulation* simulation = new Simulation(parameters);
+      double      build_time = elapsedSeconds(start);
+      
+      for (size_t l = 0; l < laws.size(); l++)
+      {
+        /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+        /* 3) Time the iterations and the score               */
+        /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+        setLaw(parameters, laws[l], names, values);
+        double jumps_time        = 0.0;
+        double update_state_time = 0.0;
+        double score_time        = 0.0;
+        double calibration_cpu   = 0.0;
+        double jumps_cpu         = 0.0;
+        double update_state_cpu  = 0.0;
+        for (int repeat = 0; repeat < nb_repeats; repeat++)
+        {
+          double repeat_calibration_cpu = timeCalibration(cycle);
+          parameters->set_prng_seed(seed);
+          simulation->reinitialize();
+          double repeat_jumps_time        = 0.0;
+          double repeat_update_state_time = 0.0;
+          double repeat_jumps_cpu         = 0.0;
+          double repeat_update_state_cpu  = 0.0;
+          for (int iteration = 0; iteration < nb_iterations; iteration++)
+          {
+            double cpu_start = threadCpuSeconds();
+            start = std::chrono::steady_clock::now();
+            simulation->compute_jumps();
+            repeat_jumps_time += elapsedSeconds(start);
+            repeat_jumps_cpu  += threadCpuSeconds()-cpu_start;
+            cpu_start = threadCpuSeconds();
+            start     = std::chrono::steady_clock::now();
+            simulation->update_state();
+            repeat_update_state_time += elapsedSeconds(start);
+            repeat_update_state_cpu  += threadCpuSeconds()-cpu_start;
+          }
+          calibration_cpu  = (repeat == 0 ? repeat_calibration_cpu : std::min(calibration_cpu, repeat_calibration_cpu));
+          jumps_cpu        = (repeat == 0 ? repeat_jumps_cpu : std::min(jumps_cpu, repeat_jumps_cpu));
+          update_state_cpu = (repeat == 0 ? repeat_update_state_cpu : std::min(update_state_cpu, repeat_update_state_cpu));
+          start = std::chrono::steady_clock::now();
+          simulation->compute_score();
+          double repeat_score_time = elapsedSeconds(start);
+          if (repeat == 0 || repeat_jumps_time+repeat_update_state_time < jumps_time+update_state_time)
+          {
+            jumps_time        = repeat_jumps_time;
+            update_state_time = repeat_update_state_time;
+          }
+          score_time = (repeat == 0 ? repeat_score_time : std::min(score_time, repeat_score_time));
+        }
+        
+        /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+        /* 4) Write the results                               */
+        /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+        long   nb_jumps        = simulation->get_number_of_jumps();
+        long   nb_steps        = simulation->get_number_of_walk_steps();
+        double jumps_per_s     = (jumps_time > 0.0 ? nb_jumps/jumps_time : 0.0);
+        double steps_per_s     = (jumps_time > 0.0 ? nb_steps/jumps_time : 0.0);
+        double ns_per_node_rep = (jumps_time+update_state_time)*1e+9/((double)nb_iterations*nb_nodes*reps[r]);
+        double rel_steps       = (jumps_cpu > 0.0 ? nb_steps/jumps_cpu*calibration_cpu : 0.0);
+        double rel_updates     = (update_state_cpu > 0.0 ? (double)nb_iterations*nb_nodes*reps[r]/update_state_cpu*calibration_cpu : 0.0);
+        output << sizes[s] << ',' << nb_nodes << ',' << reps[r] << ',' << laws[l] << ',' << nb_iterations << ',';
+        output << build_time << ',' << jumps_time << ',' << update_state_time << ',' << score_time << ',';
+        output << nb_jumps << ',' << nb_steps << ',' << jumps_per_s << ',' << steps_per_s << ',' << ns_per_node_rep << ',';
+        output << calibration_cpu << ',' << rel_steps << ',' << rel_updates << '\n';
+        output.flush();
+        std::cout << laws[l] << " " << sizes[s] << "x" << sizes[s] << " reps=" << reps[r] << ": " << jumps_per_s << " jumps/s, " << steps_per_s << " steps/s, " << ns_per_node_rep << " ns/node/rep, " << rel_steps << " steps and " << rel_updates << " updates by calibration loop\n";
+      }
+      delete simulation;
+      simulation = NULL;
+    }
+  }
+  output.close();
+  delete parameters;
+  parameters = NULL;
+}
+
+/**
+ * \brief    Run the scaling benchmark
+ * \details  For each input (the given input files, or else each synthetic lattice size) and number of
+ *           repetitions, runs nb_runs independent simulations (seeds seed to seed+nb_runs-1) on each number of
+ *           threads, as MoRIS_sweep and MoRIS_scan workers do. Each worker owns a graph, built once and reused
+ *           for all the thread counts. Speedups and efficiencies are relative to the first thread count.
+ * \param    const std::vector<std::string>& names
+ * \param    const std::vector<std::string>& values
+ * \param    const std::vector<int>& sizes
+ * \param    const std::vector<int>& reps
+ * \param    std::string law
+ * \param    const std::vector<int>& threads
+ * \param    int nb_runs
+ * \param    int nb_iterations
+ * \param    std::string folder
+ * \param    std::string output_filename
+ * \return   \e void
+ */
+void benchScaling( const std::vector<std::string>& names, const std::vector<std::string>& values, const std::vector<int>& sizes, const std::vector<int>& reps, std::string law, const std::vector<int>& threads, int nb_runs, int nb_iterations, std::string folder, std::string output_filename )
+{
+  Parameters*       parameters = buildParameters(names, values, nb_iterations);
+  unsigned long int seed       = parameters->get_prng_seed();
+  bool              synthetic  = (parameters->get_map_filename() == "");
+  TextWriter        output(output_filename);
+  if (!output.is_open())
+  {
+    std::cout << "Error: impossible to write " << output_filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  output << "input,nb_nodes,reps,law,iters,threads,runs,wall_s,runs_per_s,speedup,efficiency,peak_rss_mb\n";
+  for (size_t s = 0; s < (synthetic ? sizes.size() : 1); s++)
+  {
+    /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+    /* 1) Write the synthetic landscape if needed         */
+    /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+    std::stringstream input;
+    if (synthetic)
+    {
+      writeLattice(parameters, sizes[s], folder);
+      input << "lattice_" << sizes[s];
+    }
+    else
+    {
+      input << parameters->get_map_filename();
+    }
+    
+    for (size_t r = 0; r < reps.size(); r++)
+    {
+      std::vector<Parameters*> worker_parameters;
+      std::vector<Simulation*> worker_simulations;
+      double                   first_wall_time = 0.0;
+      double                   best_speedup    = 0.0;
+      int                      best_threads    = 0;
+      double                   best_efficiency = 0.0;
+      double                   max_peak_rss    = 0.0;
+      for (size_t t = 0; t < threads.size(); t++)
+      {
+        /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+        /* 2) Build the missing worker graphs                 */
+        /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+        while ((int)worker_simulations.size() < threads[t])
+        {
+          Parameters* worker = buildParameters(names, values, nb_iterations);
+          worker->set_map_filename(parameters->get_map_filename());
+          worker->set_network_filename(parameters->get_network_filename());
+          worker->set_sample_filename(parameters->get_sample_filename());
+          worker->set_x_introduction(parameters->get_x_introduction());
+          worker->set_y_introduction(parameters->get_y_introduction());
+          worker->set_repetitions(reps[r]);
+          setLaw(worker, law, names, values);
+          worker_parameters.push_back(worker);
+          worker_simulations.push_back(new Simulation(worker));
+        }
+        
+        /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+        /* 3) Run the simulations on the threads              */
+        /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+        resetPeakRss();
+        std::atomic<int>         next_run(0);
+        std::vector<std::thread> workers;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < threads[t]; i++)
+        {
+          workers.push_back(std::thread(runScalingWorker, worker_simulations[i], worker_parameters[i], seed, &next_run, nb_runs));
+        }
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+          workers[i].join();
+        }
+        double wall_time = elapsedSeconds(start);
+        double peak_rss  = readPeakRss();
+        
+        /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+        /* 4) Write the results                               */
+        /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+        first_wall_time   = (t == 0 ? wall_time : first_wall_time);
+        double speedup    = (wall_time > 0.0 ? first_wall_time/wall_time : 0.0);
+        double efficiency = speedup*threads[0]/threads[t];
+        if (speedup > best_speedup)
+        {
+          best_speedup    = speedup;
+          best_threads    = threads[t];
+          best_efficiency = efficiency;
+        }
+        max_peak_rss = std::max(max_peak_rss, peak_rss);
+        output << input.str() << ',' << worker_simulations[0]->get_number_of_nodes() << ',' << reps[r] << ',' << law << ',' << nb_iterations << ',';
+        output << threads[t] << ',' << nb_runs << ',' << wall_time << ',' << (wall_time > 0.0 ? nb_runs/wall_time : 0.0) << ',';
+        output << speedup << ',' << efficiency << ',' << peak_rss << '\n';
+        output.flush();
+      }
+      std::cout << input.str() << " reps=" << reps[r] << ": best speedup " << best_speedup << " with " << best_threads << " threads (efficiency " << best_efficiency << "), peak RSS " << max_peak_rss << " MB\n";
+      for (size_t i = 0; i < worker_simulations.size(); i++)
+      {
+        delete worker_simulations[i];
+        worker_simulations[i] = NULL;
+        delete worker_parameters[i];
+        worker_parameters[i] = NULL;
+      }
+    }
+  }
+  output.close();
+  delete parameters;
+  parameters = NULL;
+}
+
+/**
+ * \brief    Run simulations until the requested number of runs is reached
+ * \details  Runs are shared between the workers through an atomic counter
+ * \param    Simulation* simulation
+ * \param    Parameters* parameters
+ * \param    unsigned long int seed
+ * \param    std::atomic<int>* next_run
+ * \param    int nb_runs
+ * \return   \e void
+ */
+void runScalingWorker( Simulation* simulation, Parameters* parameters, unsigned long int seed, std::atomic<int>* next_run, int nb_runs )
+{
+  int run = (*next_run)++;
+  while (run < nb_runs)
+  {
+    MORIS_TRACE_BEGIN("simulation");
+    parameters->set_prng_seed(seed+run);
+    simulation->reinitialize();
+    while (simulation->get_iteration() < parameters->get_iterations())
+    {
+      simulation->compute_next_iteration();
+    }
+    simulation->compute_score();
+    MORIS_TRACE_END("simulation", "run", run+1);
+    run = (*next_run)++;
+  }
+}
+
+/**
+ * \brief    Compare the phase benchmark throughputs to a baseline table
+ * \details  The baseline is a results table of the phase benchmark (see -output). Each workload (lattice size,
+ *           number of repetitions, jump law and number of iterations) must be in the baseline. Throughputs are
+ *           compared relative to the calibration loop of each run (rel_steps and rel_updates columns), not in
+ *           seconds. A workload regresses when its walk steps or its state updates by calibration loop fall
+ *           below (1-tolerance) times the baseline.
+ * \param    std::string output_filename
+ * \param    std::string baseline_filename
+ * \param    double tolerance
+ * \return   \e int
+ */
+int compareToBaseline( std::string output_filename, std::string baseline_filename, double tolerance )
+{
+  std::vector<std::string> workloads;
+  std::vector<double>      rel_steps;
+  std::vector<double>      rel_updates;
+  std::vector<std::string> baseline_workloads;
+  std::vector<double>      baseline_rel_steps;
+  std::vector<double>      baseline_rel_updates;
+  readBenchTable(output_filename, workloads, rel_steps, rel_updates);
+  readBenchTable(baseline_filename, baseline_workloads, baseline_rel_steps, baseline_rel_updates);
+  int nb_regressions = 0;
+  for (size_t i = 0; i < workloads.size(); i++)
+  {
+    size_t b = std::find(baseline_workloads.begin(), baseline_workloads.end(), workloads[i])-baseline_workloads.begin();
+    if (b == baseline_workloads.size())
+    {
+      std::cout << workloads[i] << ": not in the baseline " << baseline_filename << " (MISSING)\n";
+      nb_regressions++;
+      continue;
+    }
+    double steps_ratio   = rel_steps[i]/baseline_rel_steps[b];
+    double updates_ratio = rel_updates[i]/baseline_rel_updates[b];
+    bool   regression    = (steps_ratio < 1.0-tolerance || updates_ratio < 1.0-tolerance);
+    std::cout << workloads[i] << ": " << steps_ratio << " x baseline walk steps, " << updates_ratio << " x baseline state updates" << (regression ? " (REGRESSION)" : "") << "\n";
+    nb_regressions += (int)regression;
+  }
+  if (nb_regressions > 0)
+  {
+    std::cout << "Error: " << nb_regressions << " workload(s) missing or regressed beyond the tolerance (" << tolerance << ") of " << baseline_filename << ".\n";
+  }
+  return nb_regressions;
+}
+
+/**
+ * \brief    Read the workloads and relative throughputs of a phase benchmark results table
+ * \details  Columns are found by their name in the header
+ * \param    std::string filename
+ * \param    std::vector<std::string>& workloads
+ * \param    std::vector<double>& rel_steps
+ * \param    std::vector<double>& rel_updates
+ * \return   \e void
+ */
+void readBenchTable( std::string filename, std::vector<std::string>& workloads, std::vector<double>& rel_steps, std::vector<double>& rel_updates )
+{
+  std::ifstream file(filename, std::ios::in);
+  std::string   line;
+  if (!file || !getline(file, line))
+  {
+    std::cout << "Error: unable to read the benchmark table " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  std::vector<std::string> header  = splitList("baseline", line);
+  const char*              keys[6] = {"size", "reps", "law", "iters", "rel_steps", "rel_updates"};
+  size_t                   columns[6];
+  for (int k = 0; k < 6; k++)
+  {
+    columns[k] = std::find(header.begin(), header.end(), keys[k])-header.begin();
+    if (columns[k] == header.size())
+    {
+      std::cout << "Error: " << filename << " is not a phase benchmark table (missing column " << keys[k] << ").\n";
+      exit(EXIT_FAILURE);
+    }
+  }
+  while (getline(file, line))
+  {
+    if (line == "")
+    {
+      continue;
+    }
+    std::vector<std::string> fields = splitList("baseline", line);
+    if (fields.size() != header.size())
+    {
+      std::cout << "Error: wrong number of fields in " << filename << " (" << line << ").\n";
+      exit(EXIT_FAILURE);
+    }
+    workloads.push_back(fields[columns[2]]+" "+fields[columns[0]]+"x"+fields[columns[0]]+" reps="+fields[columns[1]]+" iters="+fields[columns[3]]);
+    rel_steps.push_back(atof(fields[columns[4]].c_str()));
+    rel_updates.push_back(atof(fields[columns[5]].c_str()));
+  }
+  file.close();
+}
+
+/**
+ * \brief    Read arguments
+ * \details  Other options are MoRIS_run parameters, applied to every benchmark point (the number of
+ *           repetitions is set by the benchmark, input files and introduction coordinates too unless
+ *           the scaling benchmark is run on a given input)
+ * \param    int argc
+ * \param    char const** argv
+ * \param    std::vector<std::string>& names
+ * \param    std::vector<std::string>& values
+ * \param    std::vector<int>& sizes
+ * \param    std::vector<int>& reps
+ * \param    std::vector<std::string>& laws
+ * \param    std::vector<int>& threads
+ * \param    int& nb_runs
+ * \param    int& nb_iterations
+ * \param    int& nb_repeats
+ * \param    std::string& folder
+ * \param    std::string& output_filename
+ * \param    std::string& baseline_filename
+ * \param    double& tolerance
+ * \return   \e void
+ */
+void readArgs( int argc, char const** argv, std::vector<std::string>& names, std::vector<std::string>& values, std::vector<int>& sizes, std::vector<int>& reps, std::vector<std::string>& laws, std::vector<int>& threads, int& nb_runs, int& nb_iterations, int& nb_repeats, std::string& folder, std::string& output_filename, std::string& baseline_filename, double& tolerance )
+{
+  Parameters* parameters = new Parameters();
+  int         nb_inputs  = 0;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+    {
+      printUsage();
+      exit(EXIT_SUCCESS);
+    }
+    if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--version") == 0)
+    {
+      std::cout << PACKAGE << " (" << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << ")\n";
+      exit(EXIT_SUCCESS);
+    }
+    std::string option = argv[i];
+    while (option.size() > 0 && option[0] == '-')
+    {
+      option = option.substr(1);
+    }
+    if (i+1 == argc)
+    {
+      std::cout << "Error: " << option << " value is missing.\n";
+      exit(EXIT_FAILURE);
+    }
+    std::string value = argv[i+1];
+    if (option == "sizes")
+    {
+      sizes = parseSizes(option, value);
+    }
+    else if (option == "reps")
+    {
+      reps = parseSizes(option, value);
+    }
+    else if (option == "laws")
+    {
+      laws = splitList(option, value);
+      for (size_t l = 0; l < laws.size(); l++)
+      {
+        if (!parameters->set_parameter("law", laws[l]))
+        {
+          std::cout << "Error: unknown jump law (" << laws[l] << ").\n";
+          exit(EXIT_FAILURE);
+        }
+      }
+    }
+    else if (option == "threads")
+    {
+      threads = parseSizes(option, value);
+    }
+    else if (option == "runs")
+    {
+      nb_runs = atoi(value.c_str());
+      if (nb_runs <= 0)
+      {
+        std::cout << "Error: -runs must be a positive number.\n";
+        exit(EXIT_FAILURE);
+      }
+    }
+    else if (option == "iters")
+    {
+      nb_iterations = atoi(value.c_str());
+    }
+    else if (option == "repeat")
+    {
+      nb_repeats = atoi(value.c_str());
+      if (nb_repeats <= 0)
+      {
+        std::cout << "Error: -repeat must be a positive number.\n";
+        exit(EXIT_FAILURE);
+      }
+    }
+    else if (option == "baseline")
+    {
+      baseline_filename = value;
+    }
+    else if (option == "tolerance")
+    {
+      tolerance = atof(value.c_str());
+      if (tolerance <= 0.0 || tolerance >= 1.0)
+      {
+        std::cout << "Error: -tolerance must be in ]0,1[.\n";
+        exit(EXIT_FAILURE);
+      }
+    }
+    else if (option == "folder")
+    {
+      folder = value;
+    }
+    else if (option == "output")
+    {
+      output_filename = value;
+    }
+    else if (option == "law")
+    {
+      std::cout << "Error: -law is set by the benchmark (use -laws).\n";
+      exit(EXIT_FAILURE);
+    }
+    else if ((option == "map" || option == "network" || option == "sample" || option == "xintro" || option == "yintro") && parameters->set_parameter(option, value))
+    {
+      names.push_back(option);
+      values.push_back(value);
+      nb_inputs++;
+    }
+    else if (parameters->set_parameter(option, value))
+    {
+      names.push_back(option == "type-of-data" ? "typeofdata" : option);
+      values.push_back(value);
+    }
+    else
+    {
+      std::cout << "Error: unknown option or wrong value (" << argv[i] << " " << value << ").\n";
+      exit(EXIT_FAILURE);
+    }
+    i++;
+  }
+  delete parameters;
+  parameters = NULL;
+  if (sizes.empty())
+  {
+    sizes = {32, 64, 128};
+  }
+  if (reps.empty())
+  {
+    reps = {10, 100};
+  }
+  if (laws.empty())
+  {
+    laws = {"DIRAC", "NORMAL", "LOG_NORMAL", "CAUCHY"};
+  }
+  if (nb_iterations <= 0)
+  {
+    std::cout << "Error: -iters must be a positive number.\n";
+    exit(EXIT_FAILURE);
+  }
+  if (nb_inputs > 0 && threads.empty())
+  {
+    std::cout << "Error: input files and the introduction site are set by the phase benchmark (use -threads to benchmark a given input).\n";
+    exit(EXIT_FAILURE);
+  }
+  if (nb_inputs > 0 && nb_inputs < 5)
+  {
+    std::cout << "Error: a given input needs -map, -network, -sample, -xintro and -yintro.\n";
+    exit(EXIT_FAILURE);
+  }
+  if (baseline_filename != "" && !threads.empty())
+  {
+    std::cout << "Error: -baseline only applies to the phase benchmark.\n";
+    exit(EXIT_FAILURE);
+  }
+  if (nb_runs == 0 && !threads.empty())
+  {
+    nb_runs = 2*(*std::max_element(threads.begin(), threads.end()));
+  }
+}
+
+/**
+ * \brief    Split a comma-separated list
+ * \details  --
+ * \param    std::string option
+ * \param    std::string text
+ * \return   \e std::vector<std::string>
+ */
+std::vector<std::string> splitList( std::string option, std::string text )
+{
+  std::vector<std::string> list;
+  std::stringstream        flux(text);
+  std::string              field;
+  while (getline(flux, field, ','))
+  {
+    if (field == "")
+    {
+      std::cout << "Error: -" << option << " expects a comma-separated list (" << text << ").\n";
+      exit(EXIT_FAILURE);
+    }
+    list.push_back(field);
+  }
+  return list;
+}
+
+/**
+ * \brief    Parse a comma-separated list of positive integers
+ * \details  --
+ * \param    std::string option
+ * \param    std::string text
+ * \return   \e std::vector<int>
+ */
+std::vector<int> parseSizes( std::string option, std::string text )
+{
+  std::vector<std::string> list = splitList(option, text);
+  std::vector<int>         numbers;
+  for (size_t i = 0; i < list.size(); i++)
+  {
+    char* end    = NULL;
+    long  number = strtol(list[i].c_str(), &end, 10);
+    if (*end != '\0' || number <= 0)
+    {
+      std::cout << "Error: -" << option << " expects comma-separated positive integers (" << text << ").\n";
+      exit(EXIT_FAILURE);
+    }
+    numbers.push_back((int)number);
+  }
+  return numbers;
+}
+
+/**
+ * \brief    Build the benchmark parameters
+ * \details  Defaults are the example parameters, overridden by the MoRIS_run parameters of the command line
+ * \param    const std::vector<std::string>& names
+ * \param    const std::vector<std::string>& values
+ * \param    int nb_iterations
+ * \return   \e Parameters*
+ */
+Parameters* buildParameters( const std::vector<std::string>& names, const std::vector<std::string>& values, int nb_iterations )
+{
+  const char* defaults[][2] = {{"seed", "1"}, {"typeofdata", "PRESENCE_ABSENCE"}, {"optimfunc", "LOG_LIKELIHOOD"}, {"humanactivity", "YES"}, {"pintro", "1.0"}, {"lambda", "23.1339"}, {"w1", "0.823203"}, {"w2", "0.100882"}, {"w3", "0.0730983"}, {"w4", "0.0135895"}, {"w5", "0.0"}, {"w6", "0.0"}, {"wmin", "0.0"}};
+  Parameters* parameters = new Parameters();
+  for (int i = 0; i < 13; i++)
+  {
+    parameters->set_parameter(defaults[i][0], defaults[i][1]);
+  }
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    parameters->set_parameter(names[i], values[i]);
+  }
+  parameters->set_iterations(nb_iterations);
+  return parameters;
+}
+
+/**
+ * \brief    Write a synthetic square lattice and use it as input
+ * \details  The introduction site is the center of the lattice. The prng is reseeded with the benchmark seed.
+ * \param    Parameters* parameters
+ * \param    int size
+ * \param    std::string folder
+ * \return   \e int
+ */
+int writeLattice( Parameters* parameters, int size, std::string folder )
+{
+  std::stringstream basename;
+  basename << folder << "/lattice_" << size;
+  parameters->set_prng_seed(parameters->get_prng_seed());
+  Landscape* landscape = new Landscape(SQUARE_LATTICE, size, size, 2000.0, parameters->get_prng());
+  landscape->write_map(basename.str()+"_map.txt");
+  landscape->write_network(basename.str()+"_network.txt");
+  landscape->write_sample(basename.str()+"_sample.txt");
+  parameters->set_map_filename(basename.str()+"_map.txt");
+  parameters->set_network_filename(basename.str()+"_network.txt");
+  parameters->set_sample_filename(basename.str()+"_sample.txt");
+  parameters->set_x_introduction(landscape->get_x_center());
+  parameters->set_y_introduction(landscape->get_y_center());
+  int nb_nodes = landscape->get_number_of_cells();
+  delete landscape;
+  landscape = NULL;
+  return nb_nodes;
+}
+
+/**
+ * \brief    Set the jump law and its default parameters
+ * \details  Defaults give walks of a few cells (mu = 6 for DIRAC and NORMAL, the example log-normal law,
+ *           gamma = 2 for CAUCHY). Parameters given on the command line take precedence.
+ * \param    Parameters* parameters
+ * \param    std::string law
+ * \param    const std::vector<std::string>& names
+ * \param    const std::vector<std::string>& values
+ * \return   \e void
+ */
+void setLaw( Parameters* parameters, std::string law, const std::vector<std::string>& names, const std::vector<std::string>& values )
+{
+  parameters->set_parameter("law", law);
+  parameters->set_mu(law == "LOG_NORMAL" ? 6.4951562 : 6.0);
+  parameters->set_sigma(law == "LOG_NORMAL" ? 0.174736073 : 2.0);
+  parameters->set_gamma(2.0);
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    if (names[i] == "mu" || names[i] == "sigma" || names[i] == "gamma")
+    {
+      parameters->set_parameter(names[i], values[i]);
+    }
+  }
+}
+
+/**
+ * \brief    Reset the peak resident set size of the process
+ * \details  Only possible on Linux (/proc/self/clear_refs). Elsewhere, the peak is the peak since the start.
+ * \param    void
+ * \return   \e void
+ */
+void resetPeakRss( void )
+{
+  std::ofstream file("/proc/self/clear_refs");
+  if (file)
+  {
+    file << "5";
+  }
+}
+
+/**
+ * \brief    Read the peak resident set size of the process, in MB
+ * \details  Reads VmHWM in /proc/self/status, or else the maximum resident set size of getrusage
+ * \param    void
+ * \return   \e double
+ */
+double readPeakRss( void )
+{
+  std::ifstream file("/proc/self/status");
+  std::string   line;
+  while (getline(file, line))
+  {
+    if (line.compare(0, 6, "VmHWM:") == 0)
+    {
+      return atof(line.substr(6).c_str())/1024.0;
+    }
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss/1048576.0;
+#else
+  return usage.ru_maxrss/1024.0;
+#endif
+}
+
+/**
+ * \brief    Build the random cycle walked by the calibration loop
+ * \details  A single cycle through 2^20 indices (4 MB, about the working set of the regression workload),
+ *           drawn with Sattolo's algorithm and a fixed seed, so that every run walks the same cycle
+ * \param    std::vector<uint32_t>& cycle
+ * \return   \e void
+ */
+void buildCalibrationCycle( std::vector<uint32_t>& cycle )
+{
+  const uint32_t size  = 1048576;
+  uint64_t       state = 88172645463325252ULL;
+  cycle.resize(size);
+  for (uint32_t i = 0; i < size; i++)
+  {
+    cycle[i] = i;
+  }
+  for (uint32_t i = size-1; i > 0; i--)
+  {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    std::swap(cycle[i], cycle[state%i]);
+  }
+}
+
+/**
+ * \brief    Time the calibration loop
+ * \details  A fixed amount of work, independent of the simulation engine: 2^22 steps along the calibration
+ *           cycle, each with a xorshift draw, an unpredictable branch and a floating point update. As the
+ *           random walks of the jumps, it is bound by memory latency, so that throughputs divided by its
+ *           speed mostly cancel the differences between machines. Returns the thread CPU time in seconds.
+ * \param    const std::vector<uint32_t>& cycle
+ * \return   \e double
+ */
+double timeCalibration( const std::vector<uint32_t>& cycle )
+{
+  const long steps = 4194304;
+  uint64_t   state = 88172645463325252ULL;
+  uint32_t   index = 0;
+  double     sum   = 0.0;
+  double     start = threadCpuSeconds();
+  for (long step = 0; step < steps; step++)
+  {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    index  = cycle[index];
+    if ((state^index)&1)
+    {
+      sum += (double)index*1e-6;
+    }
+    else
+    {
+      sum *= 0.999999;
+    }
+  }
+  double elapsed = threadCpuSeconds()-start;
+  calibration_checksum = sum;
+  return elapsed;
+}
+
+/**
+ * \brief    Get the time elapsed since a time point
+ * \details  --
+ * \param    std::chrono::steady_clock::time_point start
+ * \return   \e double
+ */
+double elapsedSeconds( std::chrono::steady_clock::time_point start )
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+}
+
+/**
+ * \brief    Get the CPU time of the calling thread, in seconds
+ * \details  Unlike the elapsed time, it does not count the time slices given to other processes
+ * \param    void
+ * \return   \e double
+ */
+double threadCpuSeconds( void )
+{
+  struct timespec time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return (double)time.tv_sec+(double)time.tv_nsec*1e-9;
+}
+
+/**
+ * \brief    Print usage
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void printUsage( void )
+{
+  std::cout << "\n";
+  std::cout << "***************************************************************************\n";
+#ifdef DEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( debug )\n";
+#endif
+#ifdef NDEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( release )\n";
+#endif
+  std::cout << " MoRIS (Model of Routes of Invasive Spread)                                \n";
+  std::cout << " Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet   \n";
+  std::cout << " Web: https://github.com/charlesrocabert/MoRIS                             \n";
+  std::cout << "                                                                           \n";
+  std::cout << " This program comes with ABSOLUTELY NO WARRANTY.                           \n";
+  std::cout << " This is free software, and you are welcome to redistribute it under       \n";
+  std::cout << " certain conditions; See the GNU General Public License for details        \n";
+  std::cout << "***************************************************************************\n";
+  std::cout << "Usage: MoRIS_bench -h or --help\n";
+  std::cout << "   or: MoRIS_bench [bench options] [MoRIS_run parameters]\n";
+  std::cout << "Times the graph construction, the jumps, the state update and the score on\n";
+  std::cout << "synthetic square lattices, for each lattice size, number of repetitions and\n";
+  std::cout << "jump law. MoRIS_run parameters (see MoRIS_run -h) override the defaults of\n";
+  std::cout << "the benchmark (the example parameters), except input files and the\n";
+  std::cout << "introduction site (the center of the lattice).\n";
+  std::cout << "With -threads, runs the scaling benchmark instead: -runs simulations of the\n";
+  std::cout << "first jump law on each number of threads, for each lattice size (or the\n";
+  std::cout << "input given by -map, -network, -sample, -xintro and -yintro) and number of\n";
+  std::cout << "repetitions, reporting wall time, speedup, efficiency and peak RSS.\n";
+  std::cout << "With -baseline, compares the phase benchmark throughputs to a previous\n";
+  std::cout << "results table and exits with an error when a workload regressed.\n";
+  std::cout << "Options are:\n";
+  std::cout << "  -h, --help\n";
+  std::cout << "        print this help, then exit\n";
+  std::cout << "  -v, --version\n";
+  std::cout << "        print the current version, then exit\n";
+  std::cout << "  -sizes, --sizes <list>\n";
+  std::cout << "        Specify the lattice side lengths, in cells (default: 32,64,128)\n";
+  std::cout << "  -reps, --reps <list>\n";
+  std::cout << "        Specify the numbers of repetitions (default: 10,100)\n";
+  std::cout << "  -laws, --laws <list>\n";
+  std::cout << "        Specify the jump laws (default: DIRAC,NORMAL,LOG_NORMAL,CAUCHY)\n";
+  std::cout << "  -threads, --threads <list>\n";
+  std::cout << "        Run the scaling benchmark on these numbers of threads (e.g. 1,2,4,8)\n";
+  std::cout << "  -runs, --runs <number>\n";
+  std::cout << "        Specify the number of simulations by scaling point (default: 2 x max threads)\n";
+  std::cout << "  -iters, --iters <number>\n";
+  std::cout << "        Specify the number of timed iterations (default: 10)\n";
+  std::cout << "  -repeat, --repeat <number>\n";
+  std::cout << "        Time each phase benchmark point this number of times and keep the fastest (default: 1)\n";
+  std::cout << "  -folder, --folder <folder>\n";
+  std::cout << "        Specify the folder of the synthetic landscape files (default: bench)\n";
+  std::cout << "  -output, --output <filename>\n";
+  std::cout << "        Specify the CSV results table (default: bench.csv)\n";
+  std::cout << "  -baseline, --baseline <filename>\n";
+  std::cout << "        Compare the results to this phase benchmark table\n";
+  std::cout << "  -tolerance, --tolerance <fraction>\n";
+  std::cout << "        Specify the tolerated loss of relative throughput against the baseline (default: 0.25)\n";
+  std::cout << "\n";
+}
@@ -0,0 +1,351 @@
+/**
+ * \file      MoRIS_equivalence.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     MoRIS_equivalence executable
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "../cmake/Config.h"
+
+#include <unistd.h>
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <assert.h>
+
+#include "./lib/Parameters.h"
+#include "./lib/Simulation.h"
+#include "./lib/Landscape.h"
+#include "./lib/Equivalence.h"
+
+void printUsage( void );
+void readArgs( int argc, char const** argv, std::vector<std::string>& names, std::vector<std::string>& values, std::vector<std::string>& candidate_names, std::vector<std::string>& candidate_values, int& nb_seeds, double& alpha, double& tolerance, int& synthetic_size, std::string& folder );
+Parameters* buildParameters( const std::vector<std::string>& names, const std::vector<std::string>& values );
+void runEngine( Simulation* simulation, Parameters* parameters, unsigned long int seed, bool candidate, Equivalence* equivalence );
+
+
+/**
+ * \brief    main function
+ * \details  --
+ * \param    int argc
+ * \param    char const** argv
+ * \return   \e int
+ */
+int main(int argc, char const** argv)
+{
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Read command line arguments                     */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<std::string> names;
+  std::vector<std::string> values;
+  std::vector<std::string> candidate_names;
+  std::vector<std::string> candidate_values;
+  int                      nb_seeds       = 20;
+  double                   alpha          = 0.01;
+  double                   tolerance      = 0.02;
+  int                      synthetic_size = 0;
+  std::string              folder         = "equivalence";
+  readArgs(argc, argv, names, values, candidate_names, candidate_values, nb_seeds, alpha, tolerance, synthetic_size, folder);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Write the synthetic landscape if asked          */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  Parameters* reference = buildParameters(names, values);
+  if (synthetic_size > 0)
+  {
+    system(("mkdir -p "+folder).c_str());
+    Landscape* landscape = new Landscape(SQUARE_LATTICE, synthetic_size, synthetic_size, 2000.0, reference->get_prng());
+    landscape->write_map(folder+"/map.txt");
+    landscape->write_network(folder+"/network.txt");
+    landscape->write_sample(folder+"/sample.txt");
+    std::stringstream x_center;
+    std::stringstream y_center;
+    x_center << landscape->get_x_center();
+    y_center << landscape->get_y_center();
+    const char* inputs[5][2] = {{"map", "/map.txt"}, {"network", "/network.txt"}, {"sample", "/sample.txt"}, {"xintro", ""}, {"yintro", ""}};
+    for (int i = 0; i < 5; i++)
+    {
+      names.push_back(inputs[i][0]);
+      values.push_back(i < 3 ? folder+inputs[i][1] : (i == 3 ? x_center.str() : y_center.str()));
+    }
+    delete landscape;
+    landscape = NULL;
+    delete reference;
+    reference = buildParameters(names, values);
+  }
+  const char* mandatory[5] = {"map", "network", "sample", "xintro", "yintro"};
+  for (int i = 0; i < 5; i++)
+  {
+    if (std::find(names.begin(), names.end(), mandatory[i]) == names.end())
+    {
+      std::cout << "Error: -" << mandatory[i] << " option is mandatory without -synthetic.\n";
+      exit(EXIT_FAILURE);
+    }
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Run the reference and candidate engines         */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  names.insert(names.end(), candidate_names.begin(), candidate_names.end());
+  values.insert(values.end(), candidate_values.begin(), candidate_values.end());
+  Parameters*       candidate            = buildParameters(names, values);
+  Simulation*       reference_simulation = new Simulation(reference);
+  Simulation*       candidate_simulation = new Simulation(candidate);
+  Equivalence*      equivalence          = new Equivalence();
+  unsigned long int first_seed           = reference->get_prng_seed();
+  for (int i = 0; i < nb_seeds; i++)
+  {
+    runEngine(reference_simulation, reference, first_seed+i, false, equivalence);
+    runEngine(candidate_simulation, candidate, first_seed+nb_seeds+i, true, equivalence);
+  }
+  std::cout << nb_seeds << " reference and " << nb_seeds << " candidate runs (" << reference->get_repetitions() << " repetitions, " << reference->get_iterations() << " iterations).\n";
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 4) Test the equivalence                            */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  bool pass = equivalence->test(alpha, tolerance);
+  std::cout << (pass ? "Engines are statistically equivalent.\n" : "Engines differ.\n");
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 5) Free the memory and exit                        */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  delete equivalence;
+  equivalence = NULL;
+  delete candidate_simulation;
+  candidate_simulation = NULL;
+  delete reference_simulation;
+  reference_simulation = NULL;
+  delete candidate;
+  candidate = NULL;
+  delete reference;
+  reference = NULL;
+  return (pass ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/**
+ * \brief    Read arguments
+ * \details  Other options are MoRIS_run parameters, shared by both engines. Candidate parameters are given
+ *           as -candidate name=value, and override the shared parameters for the candidate engine only.
+ * \param    int argc
+ * \param    char const** argv
+ * \param    std::vector<std::string>& names
+ * \param    std::vector<std::string>& values
+ * \param    std::vector<std::string>& candidate_names
+ * \param    std::vector<std::string>& candidate_values
+ * \param    int& nb_seeds
+ * \param    double& alpha
+ * \param    double& tolerance
+ * \param    int& synthetic_size
+ * \param    std::string& folder
+ * \return   \e void
+ */
+void readArgs( int argc, char const** argv, std::vector<std::string>& names, std::vector<std::string>& values, std::vector<std::string>& candidate_names, std::vector<std::string>& candidate_values, int& nb_seeds, double& alpha, double& tolerance, int& synthetic_size, std::string& folder )
+{
+  Parameters* parameters = new Parameters();
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+    {
+      printUsage();
+      exit(EXIT_SUCCESS);
+    }
+    if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--version") == 0)
+    {
+      std::cout << PACKAGE << " (" << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << ")\n";
+      exit(EXIT_SUCCESS);
+    }
+    std::string option = argv[i];
+    while (option.size() > 0 && option[0] == '-')
+    {
+      option = option.substr(1);
+    }
+    if (i+1 == argc)
+    {
+      std::cout << "Error: " << option << " value is missing.\n";
+      exit(EXIT_FAILURE);
+    }
+    std::string value = argv[i+1];
+    if (option == "candidate")
+    {
+      size_t equal = value.find('=');
+      if (equal == std::string::npos || !parameters->set_parameter(value.substr(0, equal), value.substr(equal+1)))
+      {
+        std::cout << "Error: -candidate expects a MoRIS_run parameter as name=value (" << value << ").\n";
+        exit(EXIT_FAILURE);
+      }
+      candidate_names.push_back(value.substr(0, equal));
+      candidate_values.push_back(value.substr(equal+1));
+    }
+    else if (option == "seeds")
+    {
+      nb_seeds = atoi(value.c_str());
+    }
+    else if (option == "alpha")
+    {
+      alpha = atof(value.c_str());
+    }
+    else if (option == "tolerance")
+    {
+      tolerance = atof(value.c_str());
+    }
+    else if (option == "synthetic")
+    {
+      synthetic_size = atoi(value.c_str());
+    }
+    else if (option == "folder")
+    {
+      folder = value;
+    }
+    else if (parameters->set_parameter(option, value))
+    {
+      names.push_back(option == "type-of-data" ? "typeofdata" : option);
+      values.push_back(value);
+    }
+    else
+    {
+      std::cout << "Error: unknown option or wrong value (" << argv[i] << " " << value << ").\n";
+      exit(EXIT_FAILURE);
+    }
+    i++;
+  }
+  delete parameters;
+  parameters = NULL;
+  if (nb_seeds < 2)
+  {
+    std::cout << "Error: -seeds must be at least 2.\n";
+    exit(EXIT_FAILURE);
+  }
+  if (alpha <= 0.0 || alpha >= 1.0 || tolerance < 0.0)
+  {
+    std::cout << "Error: -alpha must be in ]0,1[ and -tolerance positive or null.\n";
+    exit(EXIT_FAILURE);
+  }
+  if (synthetic_size < 0)
+  {
+    std::cout << "Error: -synthetic must be a positive number.\n";
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * \brief    Build the parameters of an engine
+ * \details  Defaults are the example parameters (with 10 repetitions and 10 iterations), then the given
+ *           (name, value) pairs are applied in order
+ * \param    const std::vector<std::string>& names
+ * \param    const std::vector<std::string>& values
+ * \return   \e Parameters*
+ */
+Parameters* buildParameters( const std::vector<std::string>& names, const std::vector<std::string>& values )
+{
+  const char* defaults[][2] = {{"seed", "1"}, {"typeofdata", "PRESENCE_ABSENCE"}, {"reps", "10"}, {"iters", "10"}, {"law", "LOG_NORMAL"}, {"optimfunc", "LOG_LIKELIHOOD"}, {"humanactivity", "YES"}, {"pintro", "1.0"}, {"lambda", "23.1339"}, {"mu", "6.4951562"}, {"sigma", "0.174736073"}, {"gamma", "0.0"}, {"w1", "0.823203"}, {"w2", "0.100882"}, {"w3", "0.0730983"}, {"w4", "0.0135895"}, {"w5", "0.0"}, {"w6", "0.0"}, {"wmin", "0.0"}};
+  Parameters* parameters = new Parameters();
+  for (int i = 0; i < 19; i++)
+  {
+    parameters->set_parameter(defaults[i][0], defaults[i][1]);
+  }
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    parameters->set_parameter(names[i], values[i]);
+  }
+  return parameters;
+}
+
+/**
+ * \brief    Run an engine with a given seed and add its final state to the comparison
+ * \details  --
+ * \param    Simulation* simulation
+ * \param    Parameters* parameters
+ * \param    unsigned long int seed
+ * \param    bool candidate
+ * \param    Equivalence* equivalence
+ * \return   \e void
+ */
+void runEngine( Simulation* simulation, Parameters* parameters, unsigned long int seed, bool candidate, Equivalence* equivalence )
+{
+  std::vector<int>    identifiers;
+  std::vector<double> values;
+  parameters->set_prng_seed(seed);
+  simulation->reinitialize();
+  while (simulation->get_iteration() < parameters->get_iterations())
+  {
+    simulation->compute_next_iteration();
+  }
+  simulation->compute_score();
+  simulation->capture_state(identifiers, values);
+  equivalence->add_run(candidate, identifiers, values);
+}
+
+/**
+ * \brief    Print usage
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void printUsage( void )
+{
+  std::cout << "\n";
+  std::cout << "***************************************************************************\n";
+#ifdef DEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( debug )\n";
+#endif
+#ifdef NDEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( release )\n";
+#endif
+  std::cout << " MoRIS (Model of Routes of Invasive Spread)                                \n";
+  std::cout << " Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet   \n";
+  std::cout << " Web: https://github.com/charlesrocabert/MoRIS                             \n";
+  std::cout << "                                                                           \n";
+  std::cout << " This program comes with ABSOLUTELY NO WARRANTY.                           \n";
+  std::cout << " This is free software, and you are welcome to redistribute it under       \n";
+  std::cout << " certain conditions; See the GNU General Public License for details        \n";
+  std::cout << "***************************************************************************\n";
+  std::cout << "Usage: MoRIS_equivalence -h or --help\n";
+  std::cout << "   or: MoRIS_equivalence [options] [MoRIS_run parameters]\n";
+  std::cout << "Runs a reference and a candidate engine with independent seeds, and tests\n";
+  std::cout << "that their node invasion probabilities (p_sim), mean numbers of\n";
+  std::cout << "introductions and scores follow the same distributions. Exits with a failure\n";
+  std::cout << "status if the engines differ. MoRIS_run parameters default to the example\n";
+  std::cout << "parameters (10 repetitions, 10 iterations); input files and the\n";
+  std::cout << "introduction site are mandatory without -synthetic.\n";
+  std::cout << "Options are:\n";
+  std::cout << "  -h, --help\n";
+  std::cout << "        print this help, then exit\n";
+  std::cout << "  -v, --version\n";
+  std::cout << "        print the current version, then exit\n";
+  std::cout << "  -candidate, --candidate <name=value>\n";
+  std::cout << "        Specify a MoRIS_run parameter of the candidate engine (repeatable)\n";
+  std::cout << "  -seeds, --seeds <number>\n";
+  std::cout << "        Specify the number of runs of each engine (default: 20)\n";
+  std::cout << "  -alpha, --alpha <number>\n";
+  std::cout << "        Specify the level of the two-sample tests (default: 0.01)\n";
+  std::cout << "  -tolerance, --tolerance <number>\n";
+  std::cout << "        Specify the fraction of nodes allowed to differ beyond alpha (default: 0.02)\n";
+  std::cout << "  -synthetic, --synthetic <size>\n";
+  std::cout << "        Run on a synthetic square lattice of size x size cells\n";
+  std::cout << "  -folder, --folder <folder>\n";
+  std::cout << "        Specify the folder of the synthetic lattice files (default: equivalence)\n";
+  std::cout << "\n";
+}
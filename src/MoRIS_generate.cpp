@@ -0,0 +1,348 @@
+/**
+ * \file      MoRIS_generate.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     MoRIS_generate executable
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "../cmake/Config.h"
+
+#include <unistd.h>
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <assert.h>
+
+#include "./lib/Enums.h"
+#include "./lib/Prng.h"
+#include "./lib/Landscape.h"
+
+void printUsage( void );
+void readArgs( int argc, char const** argv, lattice_type& lattice, int& width, int& height, double& cell_size, double* road_densities, int& nb_hotspots, double& hotspot_radius, double& hotspot_intensity, double& sampling_fraction, double& mean_observations, double& invasion_radius, unsigned long int& seed, std::string& folder );
+void parseNumbers( std::string option, std::string text, size_t n, double* numbers );
+
+
+/**
+ * \brief    main function
+ * \details  --
+ * \param    int argc
+ * \param    char const** argv
+ * \return   \e int
+ */
+int main(int argc, char const** argv)
+{
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Read command line arguments                     */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  lattice_type      lattice           = SQUARE_LATTICE;
+  int               width             = 0;
+  int               height            = 0;
+  double            cell_size         = 2000.0;
+  double            road_densities[6] = {0.02, 0.05, 0.50, 0.50, 0.30, 0.20};
+  int               nb_hotspots       = 0;
+  double            hotspot_radius    = 5.0;
+  double            hotspot_intensity = 20.0;
+  double            sampling_fraction = 0.1;
+  double            mean_observations = 3.0;
+  double            invasion_radius   = 10.0;
+  unsigned long int seed              = 1;
+  std::string       folder            = "input";
+  readArgs(argc, argv, lattice, width, height, cell_size, road_densities, nb_hotspots, hotspot_radius, hotspot_intensity, sampling_fraction, mean_observations, invasion_radius, seed, folder);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Generate the landscape                          */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  Prng* prng = new Prng();
+  prng->set_seed(seed);
+  Landscape* landscape = new Landscape(lattice, width, height, cell_size, prng);
+  landscape->set_road_densities(road_densities);
+  landscape->set_hotspots(nb_hotspots, hotspot_radius*cell_size, hotspot_intensity);
+  landscape->set_sampling(sampling_fraction, mean_observations, invasion_radius*cell_size);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Write the input files                           */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  system(("mkdir -p "+folder).c_str());
+  landscape->write_map(folder+"/map.txt");
+  landscape->write_network(folder+"/network.txt");
+  landscape->write_sample(folder+"/sample.txt");
+  std::cout << landscape->get_number_of_cells() << " cells written in " << folder << "/ (map.txt, network.txt, sample.txt).\n";
+  std::cout << "Central cell: -xintro " << landscape->get_x_center() << " -yintro " << landscape->get_y_center() << "\n";
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 4) Free the memory and exit                        */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  delete landscape;
+  landscape = NULL;
+  delete prng;
+  prng = NULL;
+  return EXIT_SUCCESS;
+}
+
+/**
+ * \brief    Read arguments
+ * \details  Hotspot and invasion radii are given in cells
+ * \param    int argc
+ * \param    char const** argv
+ * \param    lattice_type& lattice
+ * \param    int& width
+ * \param    int& height
+ * \param    double& cell_size
+ * \param    double* road_densities
+ * \param    int& nb_hotspots
+ * \param    double& hotspot_radius
+ * \param    double& hotspot_intensity
+ * \param    double& sampling_fraction
+ * \param    double& mean_observations
+ * \param    double& invasion_radius
+ * \param    unsigned long int& seed
+ * \param    std::string& folder
+ * \return   \e void
+ */
+void readArgs( int argc, char const** argv, lattice_type& lattice, int& width, int& height, double& cell_size, double* road_densities, int& nb_hotspots, double& hotspot_radius, double& hotspot_intensity, double& sampling_fraction, double& mean_observations, double& invasion_radius, unsigned long int& seed, std::string& folder )
+{
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+    {
+      printUsage();
+      exit(EXIT_SUCCESS);
+    }
+    if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--version") == 0)
+    {
+      std::cout << PACKAGE << " (" << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << ")\n";
+      exit(EXIT_SUCCESS);
+    }
+    std::string option = argv[i];
+    while (option.size() > 0 && option[0] == '-')
+    {
+      option = option.substr(1);
+    }
+    if (i+1 == argc)
+    {
+      std::cout << "Error: " << option << " value is missing.\n";
+      exit(EXIT_FAILURE);
+    }
+    std::string value = argv[i+1];
+    const char* str   = value.c_str();
+    if (option == "lattice")
+    {
+      if (value == "SQUARE")
+      {
+        lattice = SQUARE_LATTICE;
+      }
+      else if (value == "HEX")
+      {
+        lattice = HEX_LATTICE;
+      }
+      else
+      {
+        std::cout << "Error: -lattice must be SQUARE or HEX.\n";
+        exit(EXIT_FAILURE);
+      }
+    }
+    else if (option == "width")
+    {
+      width = atoi(str);
+    }
+    else if (option == "height")
+    {
+      height = atoi(str);
+    }
+    else if (option == "cellsize")
+    {
+      cell_size = atof(str);
+    }
+    else if (option == "roads")
+    {
+      parseNumbers(option, value, 6, road_densities);
+    }
+    else if (option == "hotspots")
+    {
+      nb_hotspots = atoi(str);
+    }
+    else if (option == "hotspot-radius")
+    {
+      hotspot_radius = atof(str);
+    }
+    else if (option == "hotspot-intensity")
+    {
+      hotspot_intensity = atof(str);
+    }
+    else if (option == "sample-fraction")
+    {
+      sampling_fraction = atof(str);
+    }
+    else if (option == "sample-observations")
+    {
+      mean_observations = atof(str);
+    }
+    else if (option == "invasion-radius")
+    {
+      invasion_radius = atof(str);
+    }
+    else if (option == "seed")
+    {
+      seed = (unsigned)atol(str);
+    }
+    else if (option == "folder")
+    {
+      folder = value;
+    }
+    else
+    {
+      std::cout << "Error: unknown option (" << argv[i] << ").\n";
+      exit(EXIT_FAILURE);
+    }
+    i++;
+  }
+  if (height == 0)
+  {
+    height = width;
+  }
+  if (width <= 0 || height <= 0 || (double)width*(double)height > 2147483647.0)
+  {
+    std::cout << "Error: -width (and -height) must be positive numbers, for less than 2^31 cells.\n";
+    exit(EXIT_FAILURE);
+  }
+  if (cell_size <= 0.0)
+  {
+    std::cout << "Error: -cellsize must be a positive number.\n";
+    exit(EXIT_FAILURE);
+  }
+  for (int k = 0; k < 6; k++)
+  {
+    if (road_densities[k] < 0.0)
+    {
+      std::cout << "Error: -roads densities must be positive or null.\n";
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (nb_hotspots < 0 || hotspot_radius <= 0.0 || hotspot_intensity < 0.0)
+  {
+    std::cout << "Error: -hotspots, -hotspot-radius and -hotspot-intensity must be positive numbers.\n";
+    exit(EXIT_FAILURE);
+  }
+  if (sampling_fraction < 0.0 || sampling_fraction > 1.0 || mean_observations < 1.0 || invasion_radius < 0.0)
+  {
+    std::cout << "Error: -sample-fraction must be in [0,1], -sample-observations at least 1 and -invasion-radius positive or null.\n";
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * \brief    Parse a comma-separated list of numbers
+ * \details  --
+ * \param    std::string option
+ * \param    std::string text
+ * \param    size_t n
+ * \param    double* numbers
+ * \return   \e void
+ */
+void parseNumbers( std::string option, std::string text, size_t n, double* numbers )
+{
+  std::stringstream flux(text);
+  std::string       field;
+  size_t            count = 0;
+  bool              error = false;
+  while (!error && getline(flux, field, ','))
+  {
+    char* end = NULL;
+    if (count < n)
+    {
+      numbers[count] = strtod(field.c_str(), &end);
+    }
+    error = (count == n || end == field.c_str() || *end != '\0');
+    count++;
+  }
+  if (error || count != n)
+  {
+    std::cout << "Error: -" << option << " expects " << n << " comma-separated numbers (" << text << ").\n";
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * \brief    Print usage
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void printUsage( void )
+{
+  std::cout << "\n";
+  std::cout << "***************************************************************************\n";
+#ifdef DEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( debug )\n";
+#endif
+#ifdef NDEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( release )\n";
+#endif
+  std::cout << " MoRIS (Model of Routes of Invasive Spread)                                \n";
+  std::cout << " Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet   \n";
+  std::cout << " Web: https://github.com/charlesrocabert/MoRIS                             \n";
+  std::cout << "                                                                           \n";
+  std::cout << " This program comes with ABSOLUTELY NO WARRANTY.                           \n";
+  std::cout << " This is free software, and you are welcome to redistribute it under       \n";
+  std::cout << " certain conditions; See the GNU General Public License for details        \n";
+  std::cout << "***************************************************************************\n";
+  std::cout << "Usage: MoRIS_generate -h or --help\n";
+  std::cout << "   or: MoRIS_generate -width <number> [options]\n";
+  std::cout << "Writes the map, network and sample files of a synthetic landscape, to test\n";
+  std::cout << "MoRIS_run on large maps.\n";
+  std::cout << "Options are:\n";
+  std::cout << "  -h, --help\n";
+  std::cout << "        print this help, then exit\n";
+  std::cout << "  -v, --version\n";
+  std::cout << "        print the current version, then exit\n";
+  std::cout << "  -lattice, --lattice <lattice> (SQUARE or HEX)\n";
+  std::cout << "        Specify the lattice type (default: SQUARE)\n";
+  std::cout << "  -width, --width <number>\n";
+  std::cout << "        Specify the number of columns\n";
+  std::cout << "  -height, --height <number>\n";
+  std::cout << "        Specify the number of rows (default: width)\n";
+  std::cout << "  -cellsize, --cellsize <number>\n";
+  std::cout << "        Specify the distance between cell centers (default: 2000)\n";
+  std::cout << "  -roads, --roads <d1,d2,d3,d4,d5,d6>\n";
+  std::cout << "        Specify the mean number of roads of each category by edge\n";
+  std::cout << "        (default: 0.02,0.05,0.5,0.5,0.3,0.2)\n";
+  std::cout << "  -hotspots, --hotspots <number>\n";
+  std::cout << "        Specify the number of urban hotspots (default: 0)\n";
+  std::cout << "  -hotspot-radius, --hotspot-radius <number>\n";
+  std::cout << "        Specify the hotspot radius, in cells (default: 5)\n";
+  std::cout << "  -hotspot-intensity, --hotspot-intensity <number>\n";
+  std::cout << "        Specify the population multiplier at hotspot centers, minus 1 (default: 20)\n";
+  std::cout << "  -sample-fraction, --sample-fraction <number>\n";
+  std::cout << "        Specify the fraction of sampled cells (default: 0.1)\n";
+  std::cout << "  -sample-observations, --sample-observations <number>\n";
+  std::cout << "        Specify the mean number of observations by sampled cell (default: 3)\n";
+  std::cout << "  -invasion-radius, --invasion-radius <number>\n";
+  std::cout << "        Specify the radius of the synthetic invasion around the central cell,\n";
+  std::cout << "        in cells (default: 10, 0 for absences only)\n";
+  std::cout << "  -seed, --seed <number>\n";
+  std::cout << "        Specify the PRNG seed (default: 1)\n";
+  std::cout << "  -folder, --folder <folder>\n";
+  std::cout << "        Specify the output folder (default: input)\n";
+  std::cout << "\n";
+}
@@ -0,0 +1,198 @@
+/**
+ * \file      MoRIS_history.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     MoRIS_history executable
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "../cmake/Config.h"
+
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <vector>
+#include <assert.h>
+
+#include "./lib/Graph.h"
+#include "./lib/StateWriter.h"
+
+void printUsage( void );
+void readArgs( int argc, char const** argv, std::string& history_filename, int& iteration, std::string& output_filename, bool& list );
+
+
+/**
+ * \brief    main function
+ * \details  --
+ * \param    int argc
+ * \param    char const** argv
+ * \return   \e int
+ */
+int main(int argc, char const** argv)
+{
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Read command line arguments                     */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::string history_filename = "output/state_history.bin";
+  int         iteration        = -1;
+  std::string output_filename  = "";
+  bool        list             = false;
+  readArgs(argc, argv, history_filename, iteration, output_filename, list);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) List the saved iterations                       */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  if (list)
+  {
+    std::vector<int> iterations;
+    StateWriter::get_history_iterations(history_filename, iterations);
+    for (size_t i = 0; i < iterations.size(); i++)
+    {
+      std::cout << iterations[i] << "\n";
+    }
+    return EXIT_SUCCESS;
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Reconstruct and write the state                 */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<int>    identifiers;
+  std::vector<double> values;
+  if (!StateWriter::read_history(history_filename, iteration, identifiers, values))
+  {
+    std::cout << "Error: iteration " << iteration << " is not saved in " << history_filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  if (output_filename == "")
+  {
+    std::stringstream filename;
+    filename << "state_" << iteration << ".txt";
+    output_filename = filename.str();
+  }
+  Graph::write_captured_state(output_filename, identifiers, values);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * \brief    Read arguments
+ * \details  --
+ * \param    int argc
+ * \param    char const** argv
+ * \param    std::string& history_filename
+ * \param    int& iteration
+ * \param    std::string& output_filename
+ * \param    bool& list
+ * \return   \e void
+ */
+void readArgs( int argc, char const** argv, std::string& history_filename, int& iteration, std::string& output_filename, bool& list )
+{
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+    {
+      printUsage();
+      exit(EXIT_SUCCESS);
+    }
+    else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--version") == 0)
+    {
+      std::cout << PACKAGE << " (" << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << ")\n";
+      exit(EXIT_SUCCESS);
+    }
+    else if (strcmp(argv[i], "-list") == 0 || strcmp(argv[i], "--list") == 0)
+    {
+      list = true;
+    }
+    else if (i+1 == argc)
+    {
+      std::cout << "Error: " << argv[i] << " value is missing.\n";
+      exit(EXIT_FAILURE);
+    }
+    else if (strcmp(argv[i], "-history") == 0 || strcmp(argv[i], "--history") == 0)
+    {
+      history_filename = argv[++i];
+    }
+    else if (strcmp(argv[i], "-iteration") == 0 || strcmp(argv[i], "--iteration") == 0)
+    {
+      iteration = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-output") == 0 || strcmp(argv[i], "--output") == 0)
+    {
+      output_filename = argv[++i];
+    }
+    else
+    {
+      std::cout << "Error: unknown option " << argv[i] << ".\n";
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (!list && iteration < 0)
+  {
+    std::cout << "Error: -iteration or -list option is mandatory.\n";
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * \brief    Print usage
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void printUsage( void )
+{
+  std::cout << "\n";
+  std::cout << "***************************************************************************\n";
+#ifdef DEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( debug )\n";
+#endif
+#ifdef NDEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( release )\n";
+#endif
+  std::cout << " MoRIS (Model of Routes of Invasive Spread)                                \n";
+  std::cout << " Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet   \n";
+  std::cout << " Web: https://github.com/charlesrocabert/MoRIS                             \n";
+  std::cout << "                                                                           \n";
+  std::cout << " This program comes with ABSOLUTELY NO WARRANTY.                           \n";
+  std::cout << " This is free software, and you are welcome to redistribute it under       \n";
+  std::cout << " certain conditions; See the GNU General Public License for details        \n";
+  std::cout << "***************************************************************************\n";
+  std::cout << "Usage: MoRIS_history -h or --help\n";
+  std::cout << "   or: MoRIS_history [options]\n";
+  std::cout << "Reconstructs a state saved by MoRIS_run -save-history, in the format of -save-all-states.\n";
+  std::cout << "Options are:\n";
+  std::cout << "  -h, --help\n";
+  std::cout << "        print this help, then exit\n";
+  std::cout << "  -v, --version\n";
+  std::cout << "        print the current version, then exit\n";
+  std::cout << "  -history, --history <filename>\n";
+  std::cout << "        Specify the state history file (default: output/state_history.bin)\n";
+  std::cout << "  -list, --list\n";
+  std::cout << "        List the saved iterations, then exit\n";
+  std::cout << "  -iteration, --iteration <number>\n";
+  std::cout << "        Specify the iteration to reconstruct\n";
+  std::cout << "  -output, --output <filename>\n";
+  std::cout << "        Specify the output file (default: state_<iteration>.txt)\n";
+  std::cout << "\n";
+}
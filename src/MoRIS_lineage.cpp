@@ -0,0 +1,142 @@
+/**
+ * \file      MoRIS_lineage.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     MoRIS_lineage executable
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "../cmake/Config.h"
+
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <vector>
+#include <assert.h>
+
+#include "./lib/LineageWriter.h"
+
+void printUsage( void );
+void readArgs( int argc, char const** argv, std::string& input_filename, std::string& output_filename );
+
+
+/**
+ * \brief    main function
+ * \details  --
+ * \param    int argc
+ * \param    char const** argv
+ * \return   \e int
+ */
+int main(int argc, char const** argv)
+{
+  std::string input_filename  = "output/lineage_events.bin";
+  std::string output_filename = "output/lineage_tree.txt";
+  readArgs(argc, argv, input_filename, output_filename);
+  LineageWriter::convert_to_text(input_filename, output_filename);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * \brief    Read arguments
+ * \details  --
+ * \param    int argc
+ * \param    char const** argv
+ * \param    std::string& input_filename
+ * \param    std::string& output_filename
+ * \return   \e void
+ */
+void readArgs( int argc, char const** argv, std::string& input_filename, std::string& output_filename )
+{
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+    {
+      printUsage();
+      exit(EXIT_SUCCESS);
+    }
+    else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--version") == 0)
+    {
+      std::cout << PACKAGE << " (" << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << ")\n";
+      exit(EXIT_SUCCESS);
+    }
+    else if (i+1 == argc)
+    {
+      std::cout << "Error: " << argv[i] << " value is missing.\n";
+      exit(EXIT_FAILURE);
+    }
+    else if (strcmp(argv[i], "-input") == 0 || strcmp(argv[i], "--input") == 0)
+    {
+      input_filename = argv[++i];
+    }
+    else if (strcmp(argv[i], "-output") == 0 || strcmp(argv[i], "--output") == 0)
+    {
+      output_filename = argv[++i];
+    }
+    else
+    {
+      std::cout << "Error: unknown option " << argv[i] << ".\n";
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+/**
+ * \brief    Print usage
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void printUsage( void )
+{
+  std::cout << "\n";
+  std::cout << "***************************************************************************\n";
+#ifdef DEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( debug )\n";
+#endif
+#ifdef NDEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( release )\n";
+#endif
+  std::cout << " MoRIS (Model of Routes of Invasive Spread)                                \n";
+  std::cout << " Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet   \n";
+  std::cout << " Web: https://github.com/charlesrocabert/MoRIS                             \n";
+  std::cout << "                                                                           \n";
+  std::cout << " This program comes with ABSOLUTELY NO WARRANTY.                           \n";
+  std::cout << " This is free software, and you are welcome to redistribute it under       \n";
+  std::cout << " certain conditions; See the GNU General Public License for details        \n";
+  std::cout << "***************************************************************************\n";
+  std::cout << "Usage: MoRIS_lineage -h or --help\n";
+  std::cout << "   or: MoRIS_lineage [options]\n";
+  std::cout << "Converts a binary lineage file (MoRIS_run -lineage BINARY) to the lineage tree text format.\n";
+  std::cout << "Options are:\n";
+  std::cout << "  -h, --help\n";
+  std::cout << "        print this help, then exit\n";
+  std::cout << "  -v, --version\n";
+  std::cout << "        print the current version, then exit\n";
+  std::cout << "  -input, --input <filename>\n";
+  std::cout << "        Specify the binary lineage file (default: output/lineage_events.bin)\n";
+  std::cout << "  -output, --output <filename>\n";
+  std::cout << "        Specify the lineage tree text file (default: output/lineage_tree.txt)\n";
+  std::cout << "\n";
+}
@@ -46,6 +46,12 @@ class MoRIS_Optimizer:
 		self.network_filename = ""
 		self.sample_filename  = ""
 
+		#------------------------- CELL COORDINATES (loaded on demand) #
+
+		self.cell_ids = None
+		self.cell_x   = None
+		self.cell_y   = None
+
 		#------------------------- PARAMETERS #
 
 		self.seed                  = 0
@@ -634,27 +640,22 @@ class MoRIS_Optimizer:
 		#~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~#
 		return best_cmd_line, mean_cmd_line
 
+	### Load cell coordinates from the map file ###
+	def load_cell_coordinates( self ):
+		data          = np.loadtxt(self.map_filename, usecols=(0, 1, 2), ndmin=2)
+		self.cell_ids = data[:,0].astype(int)
+		self.cell_x   = data[:,1]
+		self.cell_y   = data[:,2]
+
 	### Get cell id from coordinates ###
 	def get_cell_from_coordinates( self, cell_x, cell_y ):
-		best_dist = 1e+10
-		best_id   = -1
-		f = open(self.sample_filename, "r")
-		l = f.readline()
-		while l:
-			l = l.strip("\n").split(" ")
-			cell_id = int(l[0])
-			x       = float(l[1])
-			y       = float(l[2])
-			dist    = math.sqrt((x-cell_x)*(x-cell_x)+(y-cell_y)*(y-cell_y))
-			if best_dist > dist:
-				best_dist = dist
-				best_id   = cell_id
-			l = f.readline()
-		f.close()
-		if best_id == -1:
+		if self.cell_ids is None:
+			self.load_cell_coordinates()
+		if len(self.cell_ids) == 0:
 			print("Error during cell id extraction from coordinates. Exit.")
 			sys.exit()
-		return best_id
+		dist = (self.cell_x-cell_x)*(self.cell_x-cell_x)+(self.cell_y-cell_y)*(self.cell_y-cell_y)
+		return int(self.cell_ids[np.argmin(dist)])
 
 	### Read the standard output from MoRIS_run ###
 	def read_moris_output( self, moris_output ):
@@ -41,10 +41,15 @@
 
 #include "./lib/Parameters.h"
 #include "./lib/Simulation.h"
+#include "./lib/StateWriter.h"
+#include "./lib/RasterWriter.h"
 
 void printUsage( void );
 void readArgs( int argc, char const** argv, Parameters* parameters );
-void create_output_folder( void );
+void readCheckpointArgs( int argc, char const** argv, std::string& checkpoint, int& checkpoint_every, std::string& resume );
+void readMemoryArgs( int argc, char const** argv, Parameters* parameters, bool& verbose );
+void printMemoryEstimate( Parameters* parameters, Simulation* simulation );
+void create_output_folder( bool resume );
 
 
 /**
@@ -59,45 +64,125 @@ int main(int argc, char const** argv)
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
   /* 1) Read command line arguments and load parameters */
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-  Parameters* parameters = new Parameters();
+  Parameters* parameters       = new Parameters();
+  std::string checkpoint       = "";
+  int         checkpoint_every = 10;
+  std::string resume           = "";
+  bool        verbose          = false;
   readArgs(argc, argv, parameters);
-  if (parameters->saveOutputs())
+  readCheckpointArgs(argc, argv, checkpoint, checkpoint_every, resume);
+  readMemoryArgs(argc, argv, parameters, verbose);
+  if (resume != "" && parameters->saveHistory())
   {
-    create_output_folder();
-    parameters->write_parameters("output/parameters.txt");
+    std::cout << "Error: -save-history cannot be resumed from a checkpoint.\n";
+    exit(EXIT_FAILURE);
   }
   
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-  /* 2) Create the simulation                           */
+  /* 2) Create the output folder                        */
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-  Simulation* simulation = new Simulation(parameters);
+  if (parameters->saveOutputs() || parameters->saveAllStates() || parameters->saveHistory())
+  {
+    create_output_folder(resume != "");
+  }
   
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-  /* 3) Run the simulation                              */
+  /* 3) Create the simulation                           */
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  Simulation*  simulation   = new Simulation(parameters);
+  StateWriter* state_writer = NULL;
+  if (verbose)
+  {
+    printMemoryEstimate(parameters, simulation);
+  }
+  if (parameters->saveOutputs() || parameters->saveAllStates() || parameters->saveHistory())
+  {
+    parameters->write_parameters("output/parameters.txt");
+  }
+  if (resume != "")
+  {
+    simulation->load_checkpoint(resume);
+  }
+  StateWriter* history      = NULL;
+  if (parameters->saveAllStates())
+  {
+    state_writer = new StateWriter(TEXT_STATES, "output/state_");
+  }
+  if (parameters->saveHistory())
+  {
+    history = new StateWriter(BINARY_HISTORY, "output/state_history.bin");
+  }
+  RasterWriter* raster_writer = NULL;
+  if (parameters->saveOutputs() && parameters->get_raster_format() != NO_RASTER)
+  {
+    std::vector<int>    identifiers;
+    std::vector<double> values;
+    simulation->capture_state(identifiers, values);
+    raster_writer = new RasterWriter(identifiers, values);
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 4) Run the simulation                              */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  int first_iteration = simulation->get_iteration();
   while (simulation->get_iteration() < parameters->get_iterations())
   {
-    if (parameters->saveAllStates())
+    if (checkpoint != "" && simulation->get_iteration() > first_iteration && simulation->get_iteration()%checkpoint_every == 0)
+    {
+      simulation->save_checkpoint(checkpoint);
+    }
+    if (state_writer != NULL)
     {
-      std::stringstream filename;
-      filename << "output/state_" << simulation->get_iteration() << ".txt";
-      simulation->write_state(filename.str());
+      state_writer->capture(simulation);
+    }
+    if (history != NULL)
+    {
+      history->capture(simulation);
     }
     simulation->compute_next_iteration();
   }
+  if (state_writer != NULL)
+  {
+    delete state_writer;
+    state_writer = NULL;
+  }
+  if (history != NULL)
+  {
+    delete history;
+    history = NULL;
+  }
   
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-  /* 4) Compute the score and save the final state      */
+  /* 5) Compute the score and save the final state      */
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
   simulation->compute_score();
   if (parameters->saveOutputs())
   {
     simulation->write_state("output/final_state.txt");
-    //simulation->write_invasion_euclidean_distributions("output/observed_euclidean_distribution.txt", "output/simulated_euclidean_distribution.txt");
+    simulation->write_invasion_euclidean_distributions("output/observed_euclidean_histogram.txt", "output/simulated_euclidean_histogram.txt", 100);
+    simulation->write_invasion_time_series("output/invasion_time_series.txt");
+    simulation->write_walk_statistics("output/walk_statistics.txt");
+    if (parameters->get_lineage_mode() == LINEAGE_AGGREGATED)
+    {
+      simulation->write_lineage_flows("output/lineage_flows.txt");
+    }
+    if (raster_writer != NULL)
+    {
+      const char*         fields[3] = {"p_sim", "mean_first_invasion", "node_score"};
+      std::vector<int>    identifiers;
+      std::vector<double> values;
+      simulation->capture_state(identifiers, values);
+      for (int i = 0; i < 3; i++)
+      {
+        raster_writer->write(std::string("output/raster_")+fields[i], parameters->get_raster_format(), values, Graph::get_state_value_index(fields[i]));
+      }
+      delete raster_writer;
+      raster_writer = NULL;
+    }
   }
   
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-  /* 5) Return the score, free the memory and exit      */
+  /* 6) Return the score, free the memory and exit      */
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
   double likelihood       = simulation->get_total_log_likelihood();
   double empty_likelihood = simulation->get_total_log_empty_likelihood();
@@ -349,6 +434,90 @@ void readArgs( int argc, char const** argv, Parameters* parameters )
         }
       }
     }
+    if (strcmp(argv[i], "-lineage") == 0 || strcmp(argv[i], "--lineage") == 0)
+    {
+      if (i+1 == argc)
+      {
+        std::cout << "Error: lineage value is missing.\n";
+        exit(EXIT_FAILURE);
+      }
+      else
+      {
+        if (strcmp(argv[i+1], "EVENTS") == 0)
+        {
+          parameters->set_lineage_mode(LINEAGE_EVENTS);
+        }
+        else if (strcmp(argv[i+1], "AGGREGATED") == 0)
+        {
+          parameters->set_lineage_mode(LINEAGE_AGGREGATED);
+        }
+        else if (strcmp(argv[i+1], "BINARY") == 0)
+        {
+          parameters->set_lineage_mode(LINEAGE_BINARY);
+        }
+        else
+        {
+          std::cout << "Error: wrong lineage value.\n";
+          exit(EXIT_FAILURE);
+        }
+      }
+    }
+    if (strcmp(argv[i], "-raster") == 0 || strcmp(argv[i], "--raster") == 0)
+    {
+      if (i+1 == argc)
+      {
+        std::cout << "Error: raster value is missing.\n";
+        exit(EXIT_FAILURE);
+      }
+      else
+      {
+        if (strcmp(argv[i+1], "NO") == 0)
+        {
+          parameters->set_raster_format(NO_RASTER);
+        }
+        else if (strcmp(argv[i+1], "ASC") == 0)
+        {
+          parameters->set_raster_format(ASCII_GRID);
+        }
+        else if (strcmp(argv[i+1], "FLT") == 0)
+        {
+          parameters->set_raster_format(FLOAT_GRID);
+        }
+        else
+        {
+          std::cout << "Error: wrong raster value.\n";
+          exit(EXIT_FAILURE);
+        }
+      }
+    }
+    if (strcmp(argv[i], "-order") == 0 || strcmp(argv[i], "--order") == 0)
+    {
+      if (i+1 == argc)
+      {
+        std::cout << "Error: order value is missing.\n";
+        exit(EXIT_FAILURE);
+      }
+      else
+      {
+        if (strcmp(argv[i+1], "DEFAULT") == 0)
+        {
+          parameters->set_node_order(DEFAULT_ORDER);
+        }
+        else if (strcmp(argv[i+1], "HILBERT") == 0)
+        {
+          parameters->set_node_order(HILBERT_ORDER);
+        }
+        else if (strcmp(argv[i+1], "RCM") == 0)
+        {
+          parameters->set_node_order(RCM_ORDER);
+        }
+        else
+        {
+          std::cout << "Error: wrong order value.\n";
+          exit(EXIT_FAILURE);
+        }
+      }
+    }
     if (strcmp(argv[i], "-xintro") == 0 || strcmp(argv[i], "--xintro") == 0)
     {
       if (i+1 == argc)
@@ -539,6 +708,10 @@ void readArgs( int argc, char const** argv, Parameters* parameters )
     {
       parameters->set_save_all_states(true);
     }
+    if (strcmp(argv[i], "-save-history") == 0 || strcmp(argv[i], "--save-history") == 0)
+    {
+      parameters->set_save_history(true);
+    }
   }
   bool parameter_lacking = false;
   for (auto it = options.begin(); it != options.end(); ++it)
@@ -556,6 +729,143 @@ void readArgs( int argc, char const** argv, Parameters* parameters )
   options.clear();
 }
 
+/**
+ * \brief    Read checkpoint arguments
+ * \details  -checkpoint gives the checkpoint file, saved every -checkpoint-every iterations, and -resume the
+ *           checkpoint file to resume the simulation from
+ * \param    int argc
+ * \param    char const** argv
+ * \param    std::string& checkpoint
+ * \param    int& checkpoint_every
+ * \param    std::string& resume
+ * \return   \e void
+ */
+void readCheckpointArgs( int argc, char const** argv, std::string& checkpoint, int& checkpoint_every, std::string& resume )
+{
+  for (int i = 0; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-checkpoint") == 0 || strcmp(argv[i], "--checkpoint") == 0)
+    {
+      if (i+1 == argc)
+      {
+        std::cout << "Error: checkpoint value is missing.\n";
+        exit(EXIT_FAILURE);
+      }
+      else
+      {
+        checkpoint = argv[i+1];
+      }
+    }
+    if (strcmp(argv[i], "-checkpoint-every") == 0 || strcmp(argv[i], "--checkpoint-every") == 0)
+    {
+      if (i+1 == argc)
+      {
+        std::cout << "Error: checkpoint-every value is missing.\n";
+        exit(EXIT_FAILURE);
+      }
+      else
+      {
+        checkpoint_every = atoi(argv[i+1]);
+        if (checkpoint_every < 1)
+        {
+          std::cout << "Error: checkpoint-every value must be positive.\n";
+          exit(EXIT_FAILURE);
+        }
+      }
+    }
+    if (strcmp(argv[i], "-resume") == 0 || strcmp(argv[i], "--resume") == 0)
+    {
+      if (i+1 == argc)
+      {
+        std::cout << "Error: resume value is missing.\n";
+        exit(EXIT_FAILURE);
+      }
+      else
+      {
+        resume = argv[i+1];
+      }
+    }
+  }
+}
+
+/**
+ * \brief    Read the state layout, memory budget and verbosity arguments
+ * \details  Without -memory-budget, the budget is 80% of the physical memory (no budget if it is unknown)
+ * \param    int argc
+ * \param    char const** argv
+ * \param    Parameters* parameters
+ * \param    bool& verbose
+ * \return   \e void
+ */
+void readMemoryArgs( int argc, char const** argv, Parameters* parameters, bool& verbose )
+{
+  long nb_pages  = sysconf(_SC_PHYS_PAGES);
+  long page_size = sysconf(_SC_PAGE_SIZE);
+  parameters->set_state_layout(AUTO_LAYOUT);
+  parameters->set_memory_budget(nb_pages > 0 && page_size > 0 ? 0.8*(double)nb_pages*(double)page_size/1048576.0 : 0.0);
+  for (int i = 0; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-layout") == 0 || strcmp(argv[i], "--layout") == 0)
+    {
+      if (i+1 == argc)
+      {
+        std::cout << "Error: layout value is missing.\n";
+        exit(EXIT_FAILURE);
+      }
+      else if (!parameters->set_parameter("layout", argv[i+1]))
+      {
+        std::cout << "Error: wrong layout value.\n";
+        exit(EXIT_FAILURE);
+      }
+    }
+    if (strcmp(argv[i], "-memory-budget") == 0 || strcmp(argv[i], "--memory-budget") == 0)
+    {
+      if (i+1 == argc)
+      {
+        std::cout << "Error: memory-budget value is missing.\n";
+        exit(EXIT_FAILURE);
+      }
+      else
+      {
+        double memory_budget = atof(argv[i+1]);
+        if (memory_budget <= 0.0)
+        {
+          std::cout << "Error: memory-budget value must be positive.\n";
+          exit(EXIT_FAILURE);
+        }
+        parameters->set_memory_budget(memory_budget);
+      }
+    }
+    if (strcmp(argv[i], "-verbose") == 0 || strcmp(argv[i], "--verbose") == 0)
+    {
+      verbose = true;
+    }
+  }
+}
+
+/**
+ * \brief    Print the memory estimate of each state layout, and the chosen layout
+ * \details  Printed on the standard error (the standard output returns the scores). The node and edge
+ *           counts come from the loaded graph.
+ * \param    Parameters* parameters
+ * \param    Simulation* simulation
+ * \return   \e void
+ */
+void printMemoryEstimate( Parameters* parameters, Simulation* simulation )
+{
+  int    nb_nodes = simulation->get_number_of_nodes();
+  int    nb_edges = simulation->get_number_of_edges();
+  double standard = Graph::estimate_memory(parameters, STANDARD_LAYOUT, nb_nodes, nb_edges)/1048576.0;
+  double compact  = Graph::estimate_memory(parameters, COMPACT_LAYOUT, nb_nodes, nb_edges)/1048576.0;
+  std::cerr << "Memory estimate (" << nb_nodes << " nodes, " << nb_edges << " edges, " << parameters->get_repetitions() << " repetitions): ";
+  std::cerr << "STANDARD layout " << standard << " MB, COMPACT layout " << compact << " MB";
+  if (parameters->get_memory_budget() > 0.0)
+  {
+    std::cerr << ", budget " << parameters->get_memory_budget() << " MB";
+  }
+  std::cerr << " -> " << (parameters->get_state_layout() == COMPACT_LAYOUT ? "COMPACT" : "STANDARD") << " layout\n";
+}
+
 /**
  * \brief    Print usage
  * \details  --
@@ -636,21 +946,50 @@ void printUsage( void )
   std::cout << "  -wmin, --wmin <weight>\n";
   std::cout << "        Specify the minimal weight between cells\n";
   std::cout << "  -save-outputs, --save-outputs\n";
-  std::cout << "        Save simulation outputs (final state, lineage tree, ...)\n";
+  std::cout << "        Save simulation outputs (final state, lineage tree, invasion time series, ...)\n";
   std::cout << "  -save-all-states, --save--all-states\n";
   std::cout << "        Save simulation state at any time\n";
+  std::cout << "  -lineage, --lineage <mode>\n";
+  std::cout << "        Specify the lineage tree output with -save-outputs (EVENTS: one line by jump in lineage_tree.txt,\n";
+  std::cout << "        AGGREGATED: jumps aggregated by start cell, end cell and iteration in lineage_flows.txt,\n";
+  std::cout << "        BINARY: one compressed binary record by jump in lineage_events.bin, see MoRIS_lineage) (default: EVENTS)\n";
+  std::cout << "  -checkpoint, --checkpoint <filename>\n";
+  std::cout << "        Save a checkpoint of the simulation in a binary file (see -checkpoint-every)\n";
+  std::cout << "  -checkpoint-every, --checkpoint-every <iterations>\n";
+  std::cout << "        Specify the number of iterations between checkpoints (default: 10)\n";
+  std::cout << "  -resume, --resume <filename>\n";
+  std::cout << "        Resume the simulation from a checkpoint, with the same parameters, output options, layout and order\n";
+  std::cout << "  -raster, --raster <format>\n";
+  std::cout << "        Export p_sim, mean_first_invasion and node_score rasters with -save-outputs (NO, ASC: ESRI ASCII grid,\n";
+  std::cout << "        FLT: ESRI float32 grid with its .hdr header) (default: NO)\n";
+  std::cout << "  -save-history, --save-history\n";
+  std::cout << "        Save the state at any time in a delta-encoded binary file (read it with MoRIS_history)\n";
+  std::cout << "  -layout, --layout <layout>\n";
+  std::cout << "        Specify the layout of the node states (STANDARD: 32 bytes by node and repetition, COMPACT: 13 bytes,\n";
+  std::cout << "        same results; AUTO: STANDARD, or COMPACT if only this one fits in -memory-budget) (default: AUTO)\n";
+  std::cout << "  -memory-budget, --memory-budget <MB>\n";
+  std::cout << "        Refuse to run if the estimated memory footprint exceeds this budget (default: 80% of the physical memory)\n";
+  std::cout << "  -verbose, --verbose\n";
+  std::cout << "        Print the memory estimate of each layout and the chosen layout on the standard error\n";
+  std::cout << "  -order, --order <order>\n";
+  std::cout << "        Specify the order of the cells in memory and in the simulation loop (DEFAULT, HILBERT: Hilbert curve\n";
+  std::cout << "        of the coordinates, RCM: reverse Cuthill-McKee order of the network; statistically equivalent results)\n";
+  std::cout << "        (default: DEFAULT)\n";
   std::cout << "\n";
 }
 
 /**
  * \brief    Create outputs folder
- * \details  --
- * \param    void
+ * \details  The previous outputs are removed, except when resuming from a checkpoint
+ * \param    bool resume
  * \return   \e void
  */
-void create_output_folder( void )
+void create_output_folder( bool resume )
 {
-  system("rm -rf output");
-  system("mkdir output");
+  if (!resume)
+  {
+    system("rm -rf output");
+  }
+  system("mkdir -p output");
 }
 
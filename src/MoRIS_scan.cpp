@@ -0,0 +1,409 @@
+/**
+ * \file      MoRIS_scan.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     MoRIS_scan executable
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "../cmake/Config.h"
+
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <assert.h>
+
+#include "./lib/Parameters.h"
+#include "./lib/Node.h"
+#include "./lib/Graph.h"
+#include "./lib/Sweep.h"
+
+void printUsage( void );
+void readArgs( int argc, char const** argv, std::vector<std::string>& names, std::vector<std::string>& values, std::string& candidates_filename, std::string& box, std::string& circle, int& every, int& nb_threads, std::string& output_filename );
+void loadCandidates( Graph* graph, std::string filename, std::vector<Node*>& candidates );
+void parseNumbers( std::string option, std::string text, size_t n, double* numbers );
+std::string formatCoordinate( double value );
+
+
+/**
+ * \brief    main function
+ * \details  --
+ * \param    int argc
+ * \param    char const** argv
+ * \return   \e int
+ */
+int main(int argc, char const** argv)
+{
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Read command line arguments                     */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<std::string> names;
+  std::vector<std::string> values;
+  std::string              candidates_filename = "";
+  std::string              box                 = "";
+  std::string              circle              = "";
+  int                      every               = 1;
+  int                      nb_threads          = 1;
+  std::string              output_filename     = "scan.txt";
+  readArgs(argc, argv, names, values, candidates_filename, box, circle, every, nb_threads, output_filename);
+  const char* mandatory[22] = {"seed", "typeofdata", "network", "map", "sample", "reps", "iters", "law", "optimfunc", "humanactivity", "pintro", "lambda", "mu", "sigma", "gamma", "w1", "w2", "w3", "w4", "w5", "w6", "wmin"};
+  bool parameter_lacking = false;
+  for (int i = 0; i < 22; i++)
+  {
+    if (std::find(names.begin(), names.end(), mandatory[i]) == names.end())
+    {
+      std::cout << "-" << mandatory[i] << " option is mandatory.\n";
+      parameter_lacking = true;
+    }
+  }
+  if (parameter_lacking)
+  {
+    exit(EXIT_FAILURE);
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Select the candidate introduction cells         */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  Parameters* parameters = new Parameters();
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    parameters->set_parameter(names[i], values[i]);
+  }
+  parameters->set_repetitions(1);
+  Graph*             graph = new Graph(parameters);
+  std::vector<Node*> candidates;
+  if (candidates_filename != "")
+  {
+    loadCandidates(graph, candidates_filename, candidates);
+  }
+  else if (box != "")
+  {
+    double numbers[4];
+    parseNumbers("box", box, 4, numbers);
+    graph->get_nodes_in_box(numbers[0], numbers[1], numbers[2], numbers[3], candidates);
+  }
+  else
+  {
+    double numbers[3];
+    parseNumbers("circle", circle, 3, numbers);
+    graph->get_nodes_in_radius(numbers[0], numbers[1], numbers[2], candidates);
+  }
+  std::vector<std::string>                labels;
+  std::vector< std::vector<std::string> > design;
+  for (size_t i = 0; i < candidates.size(); i += (size_t)every)
+  {
+    std::vector<std::string> set;
+    set.push_back(formatCoordinate(candidates[i]->get_x()));
+    set.push_back(formatCoordinate(candidates[i]->get_y()));
+    design.push_back(set);
+    labels.push_back(std::to_string(candidates[i]->get_identifier()));
+  }
+  candidates.clear();
+  delete graph;
+  graph = NULL;
+  delete parameters;
+  parameters = NULL;
+  if (design.size() == 0)
+  {
+    std::cout << "Error: no candidate introduction cell.\n";
+    exit(EXIT_FAILURE);
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Evaluate the candidates                         */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  Sweep* sweep = new Sweep(names, values, nb_threads);
+  std::vector<std::string> design_names;
+  design_names.push_back("xintro");
+  design_names.push_back("yintro");
+  sweep->set_design(design_names, design);
+  sweep->set_labels("cell", labels);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  int nb_evaluated = sweep->run(output_filename);
+  double elapsed   = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+  std::cout << nb_evaluated << " candidate cells evaluated (" << sweep->get_number_of_sets()-nb_evaluated << " restored) with " << nb_threads << " threads in " << elapsed << " seconds.\n";
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 4) Free the memory and exit                        */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  delete sweep;
+  sweep = NULL;
+  return EXIT_SUCCESS;
+}
+
+/**
+ * \brief    Read arguments
+ * \details  Simulation parameters use the MoRIS_run options, except the introduction coordinates
+ * \param    int argc
+ * \param    char const** argv
+ * \param    std::vector<std::string>& names
+ * \param    std::vector<std::string>& values
+ * \param    std::string& candidates_filename
+ * \param    std::string& box
+ * \param    std::string& circle
+ * \param    int& every
+ * \param    int& nb_threads
+ * \param    std::string& output_filename
+ * \return   \e void
+ */
+void readArgs( int argc, char const** argv, std::vector<std::string>& names, std::vector<std::string>& values, std::string& candidates_filename, std::string& box, std::string& circle, int& every, int& nb_threads, std::string& output_filename )
+{
+  Parameters* parameters = new Parameters();
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+    {
+      printUsage();
+      exit(EXIT_SUCCESS);
+    }
+    if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--version") == 0)
+    {
+      std::cout << PACKAGE << " (" << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << ")\n";
+      exit(EXIT_SUCCESS);
+    }
+    std::string option = argv[i];
+    while (option.size() > 0 && option[0] == '-')
+    {
+      option = option.substr(1);
+    }
+    if (i+1 == argc)
+    {
+      std::cout << "Error: " << option << " value is missing.\n";
+      exit(EXIT_FAILURE);
+    }
+    std::string value = argv[i+1];
+    if (option == "candidates")
+    {
+      candidates_filename = value;
+    }
+    else if (option == "box")
+    {
+      box = value;
+    }
+    else if (option == "circle")
+    {
+      circle = value;
+    }
+    else if (option == "every")
+    {
+      every = atoi(value.c_str());
+    }
+    else if (option == "threads")
+    {
+      nb_threads = atoi(value.c_str());
+    }
+    else if (option == "output")
+    {
+      output_filename = value;
+    }
+    else if (option == "xintro" || option == "yintro")
+    {
+      std::cout << "Error: -" << option << " is set by the scan for each candidate cell.\n";
+      exit(EXIT_FAILURE);
+    }
+    else if (parameters->set_parameter(option, value))
+    {
+      names.push_back(option == "type-of-data" ? "typeofdata" : option);
+      values.push_back(value);
+    }
+    else
+    {
+      std::cout << "Error: unknown option or wrong value (" << argv[i] << " " << value << ").\n";
+      exit(EXIT_FAILURE);
+    }
+    i++;
+  }
+  delete parameters;
+  parameters = NULL;
+  if ((candidates_filename != "")+(box != "")+(circle != "") != 1)
+  {
+    std::cout << "Error: exactly one of -candidates, -box and -circle is mandatory.\n";
+    exit(EXIT_FAILURE);
+  }
+  if (every <= 0)
+  {
+    std::cout << "Error: -every must be a positive number.\n";
+    exit(EXIT_FAILURE);
+  }
+  if (nb_threads <= 0)
+  {
+    std::cout << "Error: -threads must be a positive number.\n";
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * \brief    Load the candidate introduction cells
+ * \details  Each line gives either a cell identifier, or "x y" coordinates (the nearest cell is used).
+ *           Duplicated cells are only kept once.
+ * \param    Graph* graph
+ * \param    std::string filename
+ * \param    std::vector<Node*>& candidates
+ * \return   \e void
+ */
+void loadCandidates( Graph* graph, std::string filename, std::vector<Node*>& candidates )
+{
+  std::ifstream file(filename, std::ios::in);
+  if (!file)
+  {
+    std::cout << "Error: unable to open candidates file " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  candidates.clear();
+  std::unordered_map<int, bool> selected;
+  std::string line;
+  while(getline(file, line))
+  {
+    std::stringstream   flux(line);
+    std::vector<double> fields;
+    double              field = 0.0;
+    while (flux >> field)
+    {
+      fields.push_back(field);
+    }
+    Node* node = NULL;
+    if (fields.size() == 0)
+    {
+      continue;
+    }
+    else if (fields.size() == 1)
+    {
+      node = graph->get_node((int)fields[0]);
+    }
+    else if (fields.size() == 2)
+    {
+      node = graph->get_nearest_node(fields[0], fields[1]);
+    }
+    if (node == NULL)
+    {
+      std::cout << "Error: wrong candidate line \"" << line << "\".\n";
+      exit(EXIT_FAILURE);
+    }
+    if (selected.find(node->get_identifier()) == selected.end())
+    {
+      selected[node->get_identifier()] = true;
+      candidates.push_back(node);
+    }
+  }
+  file.close();
+}
+
+/**
+ * \brief    Parse a comma-separated list of numbers
+ * \details  --
+ * \param    std::string option
+ * \param    std::string text
+ * \param    size_t n
+ * \param    double* numbers
+ * \return   \e void
+ */
+void parseNumbers( std::string option, std::string text, size_t n, double* numbers )
+{
+  std::stringstream flux(text);
+  std::string       field;
+  size_t            count = 0;
+  bool              error = false;
+  while (!error && getline(flux, field, ','))
+  {
+    char* end = NULL;
+    if (count < n)
+    {
+      numbers[count] = strtod(field.c_str(), &end);
+    }
+    error = (count == n || end == field.c_str() || *end != '\0');
+    count++;
+  }
+  if (error || count != n)
+  {
+    std::cout << "Error: -" << option << " expects " << n << " comma-separated numbers (" << text << ").\n";
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * \brief    Format a coordinate so that it reads back exactly
+ * \details  --
+ * \param    double value
+ * \return   \e std::string
+ */
+std::string formatCoordinate( double value )
+{
+  std::stringstream flux;
+  flux.precision(17);
+  flux << value;
+  return flux.str();
+}
+
+/**
+ * \brief    Print usage
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void printUsage( void )
+{
+  std::cout << "\n";
+  std::cout << "***************************************************************************\n";
+#ifdef DEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( debug )\n";
+#endif
+#ifdef NDEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( release )\n";
+#endif
+  std::cout << " MoRIS (Model of Routes of Invasive Spread)                                \n";
+  std::cout << " Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet   \n";
+  std::cout << " Web: https://github.com/charlesrocabert/MoRIS                             \n";
+  std::cout << "                                                                           \n";
+  std::cout << " This program comes with ABSOLUTELY NO WARRANTY.                           \n";
+  std::cout << " This is free software, and you are welcome to redistribute it under       \n";
+  std::cout << " certain conditions; See the GNU General Public License for details        \n";
+  std::cout << "***************************************************************************\n";
+  std::cout << "Usage: MoRIS_scan -h or --help\n";
+  std::cout << "   or: MoRIS_scan [candidates] [scan options] [MoRIS_run parameters]\n";
+  std::cout << "All the MoRIS_run parameters (see MoRIS_run -h) are mandatory, except\n";
+  std::cout << "-xintro and -yintro which are set by the scan for each candidate cell.\n";
+  std::cout << "Options are:\n";
+  std::cout << "  -h, --help\n";
+  std::cout << "        print this help, then exit\n";
+  std::cout << "  -v, --version\n";
+  std::cout << "        print the current version, then exit\n";
+  std::cout << "  -candidates, --candidates <filename>\n";
+  std::cout << "        Specify a file of candidate cells (one cell identifier or \"x y\" coordinates by line)\n";
+  std::cout << "  -box, --box <xmin,xmax,ymin,ymax>\n";
+  std::cout << "        Scan all the cells in a box\n";
+  std::cout << "  -circle, --circle <x,y,radius>\n";
+  std::cout << "        Scan all the cells in a circle\n";
+  std::cout << "  -every, --every <number>\n";
+  std::cout << "        Only keep one candidate cell out of <number> (default: 1)\n";
+  std::cout << "  -threads, --threads <number>\n";
+  std::cout << "        Specify the number of threads (default: 1)\n";
+  std::cout << "  -output, --output <filename>\n";
+  std::cout << "        Specify the score map (default: scan.txt). An existing score map is resumed\n";
+  std::cout << "\n";
+}
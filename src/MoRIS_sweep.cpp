@@ -0,0 +1,275 @@
+/**
+ * \file      MoRIS_sweep.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     MoRIS_sweep executable
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "../cmake/Config.h"
+
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <vector>
+#include <chrono>
+#include <assert.h>
+
+#include "./lib/Parameters.h"
+#include "./lib/Sweep.h"
+
+void printUsage( void );
+void readArgs( int argc, char const** argv, std::vector<std::string>& names, std::vector<std::string>& values, std::string& design_type, std::string& design_filename, int& nb_samples, int& nb_threads, std::string& output_filename, std::string& save_design_filename );
+
+
+/**
+ * \brief    main function
+ * \details  --
+ * \param    int argc
+ * \param    char const** argv
+ * \return   \e int
+ */
+int main(int argc, char const** argv)
+{
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Read command line arguments                     */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<std::string> names;
+  std::vector<std::string> values;
+  std::string              design_type          = "";
+  std::string              design_filename      = "";
+  int                      nb_samples           = 0;
+  int                      nb_threads           = 1;
+  std::string              output_filename      = "sweep.txt";
+  std::string              save_design_filename = "";
+  readArgs(argc, argv, names, values, design_type, design_filename, nb_samples, nb_threads, output_filename, save_design_filename);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Build the design                                */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  Sweep* sweep = new Sweep(names, values, nb_threads);
+  if (design_type == "design")
+  {
+    sweep->load_design(design_filename);
+  }
+  else if (design_type == "grid")
+  {
+    sweep->build_grid_design(design_filename);
+  }
+  else if (design_type == "lhs")
+  {
+    unsigned long int seed = 0;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+      if (names[i] == "seed")
+      {
+        seed = (unsigned)atol(values[i].c_str());
+      }
+    }
+    sweep->build_latin_hypercube_design(design_filename, nb_samples, seed);
+  }
+  if (save_design_filename != "")
+  {
+    sweep->write_design(save_design_filename);
+  }
+  const char* mandatory[24] = {"seed", "typeofdata", "network", "map", "sample", "reps", "iters", "law", "optimfunc", "humanactivity", "xintro", "yintro", "pintro", "lambda", "mu", "sigma", "gamma", "w1", "w2", "w3", "w4", "w5", "w6", "wmin"};
+  bool parameter_lacking = false;
+  for (int i = 0; i < 24; i++)
+  {
+    if (!sweep->is_defined(mandatory[i]))
+    {
+      std::cout << "-" << mandatory[i] << " option is mandatory (on the command line or in the design).\n";
+      parameter_lacking = true;
+    }
+  }
+  if (parameter_lacking)
+  {
+    exit(EXIT_FAILURE);
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Run the sweep                                   */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  int nb_evaluated = sweep->run(output_filename);
+  double elapsed   = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+  std::cout << nb_evaluated << " parameter sets evaluated (" << sweep->get_number_of_sets()-nb_evaluated << " restored) with " << nb_threads << " threads in " << elapsed << " seconds.\n";
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 4) Free the memory and exit                        */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  delete sweep;
+  sweep = NULL;
+  return EXIT_SUCCESS;
+}
+
+/**
+ * \brief    Read arguments
+ * \details  Simulation parameters use the MoRIS_run options, and are shared by all the parameter sets
+ * \param    int argc
+ * \param    char const** argv
+ * \param    std::vector<std::string>& names
+ * \param    std::vector<std::string>& values
+ * \param    std::string& design_type
+ * \param    std::string& design_filename
+ * \param    int& nb_samples
+ * \param    int& nb_threads
+ * \param    std::string& output_filename
+ * \param    std::string& save_design_filename
+ * \return   \e void
+ */
+void readArgs( int argc, char const** argv, std::vector<std::string>& names, std::vector<std::string>& values, std::string& design_type, std::string& design_filename, int& nb_samples, int& nb_threads, std::string& output_filename, std::string& save_design_filename )
+{
+  Parameters* parameters = new Parameters();
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+    {
+      printUsage();
+      exit(EXIT_SUCCESS);
+    }
+    if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--version") == 0)
+    {
+      std::cout << PACKAGE << " (" << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << ")\n";
+      exit(EXIT_SUCCESS);
+    }
+    std::string option = argv[i];
+    while (option.size() > 0 && option[0] == '-')
+    {
+      option = option.substr(1);
+    }
+    if (i+1 == argc)
+    {
+      std::cout << "Error: " << option << " value is missing.\n";
+      exit(EXIT_FAILURE);
+    }
+    std::string value = argv[i+1];
+    if (option == "design" || option == "grid" || option == "lhs")
+    {
+      if (design_type != "")
+      {
+        std::cout << "Error: only one of -design, -grid and -lhs can be used.\n";
+        exit(EXIT_FAILURE);
+      }
+      design_type     = option;
+      design_filename = value;
+    }
+    else if (option == "lhs-samples")
+    {
+      nb_samples = atoi(value.c_str());
+    }
+    else if (option == "threads")
+    {
+      nb_threads = atoi(value.c_str());
+    }
+    else if (option == "output")
+    {
+      output_filename = value;
+    }
+    else if (option == "save-design")
+    {
+      save_design_filename = value;
+    }
+    else if (parameters->set_parameter(option, value))
+    {
+      names.push_back(option == "type-of-data" ? "typeofdata" : option);
+      values.push_back(value);
+    }
+    else
+    {
+      std::cout << "Error: unknown option or wrong value (" << argv[i] << " " << value << ").\n";
+      exit(EXIT_FAILURE);
+    }
+    i++;
+  }
+  delete parameters;
+  parameters = NULL;
+  if (design_type == "")
+  {
+    std::cout << "Error: a design is mandatory (-design, -grid or -lhs).\n";
+    exit(EXIT_FAILURE);
+  }
+  if (design_type == "lhs" && nb_samples <= 0)
+  {
+    std::cout << "Error: -lhs-samples must be a positive number with -lhs.\n";
+    exit(EXIT_FAILURE);
+  }
+  if (nb_threads <= 0)
+  {
+    std::cout << "Error: -threads must be a positive number.\n";
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * \brief    Print usage
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void printUsage( void )
+{
+  std::cout << "\n";
+  std::cout << "***************************************************************************\n";
+#ifdef DEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( debug )\n";
+#endif
+#ifdef NDEBUG
+  std::cout << " " << PACKAGE << " " << VERSION_MAJOR << "." << VERSION_MINOR << "." << VERSION_PATCH << " ( release )\n";
+#endif
+  std::cout << " MoRIS (Model of Routes of Invasive Spread)                                \n";
+  std::cout << " Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet   \n";
+  std::cout << " Web: https://github.com/charlesrocabert/MoRIS                             \n";
+  std::cout << "                                                                           \n";
+  std::cout << " This program comes with ABSOLUTELY NO WARRANTY.                           \n";
+  std::cout << " This is free software, and you are welcome to redistribute it under       \n";
+  std::cout << " certain conditions; See the GNU General Public License for details        \n";
+  std::cout << "***************************************************************************\n";
+  std::cout << "Usage: MoRIS_sweep -h or --help\n";
+  std::cout << "   or: MoRIS_sweep [design] [sweep options] [MoRIS_run parameters]\n";
+  std::cout << "Each MoRIS_run parameter (see MoRIS_run -h) must be given either on the\n";
+  std::cout << "command line (shared by all the sets) or as a column of the design.\n";
+  std::cout << "Input files and the number of repetitions cannot be swept.\n";
+  std::cout << "Options are:\n";
+  std::cout << "  -h, --help\n";
+  std::cout << "        print this help, then exit\n";
+  std::cout << "  -v, --version\n";
+  std::cout << "        print the current version, then exit\n";
+  std::cout << "  -design, --design <filename>\n";
+  std::cout << "        Specify a CSV file of parameter sets (header with parameter names, one set by line)\n";
+  std::cout << "  -grid, --grid <filename>\n";
+  std::cout << "        Specify a full factorial design (one \"name min max n\" line by parameter)\n";
+  std::cout << "  -lhs, --lhs <filename>\n";
+  std::cout << "        Specify a Latin hypercube design (one \"name min max\" line by parameter)\n";
+  std::cout << "  -lhs-samples, --lhs-samples <number>\n";
+  std::cout << "        Specify the number of Latin hypercube samples (drawn with -seed)\n";
+  std::cout << "  -threads, --threads <number>\n";
+  std::cout << "        Specify the number of threads (default: 1)\n";
+  std::cout << "  -output, --output <filename>\n";
+  std::cout << "        Specify the results table (default: sweep.txt). An existing table is resumed\n";
+  std::cout << "  -save-design, --save-design <filename>\n";
+  std::cout << "        Save the design in a CSV file\n";
+  std::cout << "\n";
+}
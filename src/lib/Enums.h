@@ -63,5 +63,115 @@ enum optimization_function
   LIKELIHOOD_LSS = 2  /*!< Likelihood least-square-sum score */
 };
 
+/**
+ * \brief   State output format
+ * \details --
+ */
+enum state_output_format
+{
+  TEXT_STATES    = 0, /*!< One text file by iteration        */
+  BINARY_HISTORY = 1  /*!< Delta-encoded binary history file */
+};
+
+/**
+ * \brief   Lineage tree output mode
+ * \details --
+ */
+enum lineage_mode
+{
+  LINEAGE_EVENTS     = 0, /*!< One line by successful jump                           */
+  LINEAGE_AGGREGATED = 1, /*!< Jumps aggregated by (start node, end node, iteration)   */
+  LINEAGE_BINARY     = 2  /*!< One compressed binary record by successful jump        */
+};
+
+/**
+ * \brief   Raster output format
+ * \details --
+ */
+enum raster_format
+{
+  NO_RASTER  = 0, /*!< No raster output                          */
+  ASCII_GRID = 1, /*!< ESRI ASCII grid (.asc)                    */
+  FLOAT_GRID = 2  /*!< ESRI binary float32 grid (.flt and .hdr)  */
+};
+
+/**
+ * \brief   Layout of the node states by repetition
+ * \details Both layouts give the same results, as long as the number of introductions in a node and a
+ *          repetition stays below 2^24 (exact integers in single precision)
+ */
+enum state_layout
+{
+  STANDARD_LAYOUT = 0, /*!< Integer states, double precision counts and ages (32 bytes by repetition)    */
+  COMPACT_LAYOUT  = 1, /*!< Packed state bits, single precision counts and ages (13 bytes by repetition) */
+  AUTO_LAYOUT     = 2  /*!< STANDARD, or COMPACT if only this one fits in the memory budget (chosen by the
+                            graph once loaded, see Graph::choose_state_layout())                          */
+};
+
+/**
+ * \brief   Order of the nodes in memory and in the simulation loop
+ * \details The order changes the sequence of random draws: runs in different orders are only statistically
+ *          equivalent
+ */
+enum node_order
+{
+  DEFAULT_ORDER = 0, /*!< Hash map order of the identifiers, nodes allocated in the map file order */
+  HILBERT_ORDER = 1, /*!< Hilbert curve order of the node coordinates                              */
+  RCM_ORDER     = 2  /*!< Reverse Cuthill-McKee order of the road network                          */
+};
+
+/**
+ * \brief   Synthetic landscape lattice
+ * \details --
+ */
+enum lattice_type
+{
+  SQUARE_LATTICE = 0, /*!< Square cells, 4 neighbors                    */
+  HEX_LATTICE    = 1  /*!< Hexagonal cells (offset rows), 6 neighbors   */
+};
+
+/**
+ * \brief   Instrumentation counters
+ * \details Only recorded when built with MORIS_INSTRUMENTATION (see Instrumentation.h)
+ */
+enum instrumentation_counter
+{
+  ITERATIONS             = 0, /*!< Number of computed iterations                                  */
+  JUMPS_DRAWN            = 1, /*!< Number of jumps drawn                                          */
+  WALK_STEPS             = 2, /*!< Number of walk steps (calls to Node::jump())                   */
+  TRAPPED_STEPS          = 3, /*!< Walk steps staying on a node without untagged neighbor         */
+  WALKS_COMPLETED        = 4, /*!< Walks reaching their jump size without dead end                */
+  WALKS_TRAPPED_AT_START = 5, /*!< Walks stopped because the start node has no untagged neighbor  */
+  WALKS_TRAPPED          = 6, /*!< Walks reaching a node without untagged neighbor (dead end)     */
+  WALKS_LEFT_MAP         = 7, /*!< Walks stopped by a NULL neighbor (leaving the map)             */
+  PEAK_TAGGED_NODES      = 8, /*!< Peak size of the tagged nodes list during a walk               */
+  NB_COUNTERS            = 9  /*!< Number of counters                                             */
+};
+
+/**
+ * \brief   Instrumentation timers
+ * \details Only recorded when built with MORIS_INSTRUMENTATION (see Instrumentation.h)
+ */
+enum instrumentation_timer
+{
+  JUMP_PHASE         = 0, /*!< Jumps of all the nodes (Simulation::compute_next_iteration()) */
+  UPDATE_STATE_PHASE = 1, /*!< Node states update (Graph::update_state())                    */
+  SCORE_PHASE        = 2, /*!< Scoring (Graph::compute_score())                              */
+  NB_TIMERS          = 3  /*!< Number of timers                                              */
+};
+
+/**
+ * \brief   Hardware performance counters, attributed to the instrumentation timers
+ * \details Only recorded when built with MORIS_PERF_COUNTERS on Linux (see Instrumentation.h)
+ */
+enum hardware_event
+{
+  CPU_CYCLES         = 0, /*!< CPU cycles                           */
+  INSTRUCTIONS       = 1, /*!< Retired instructions                 */
+  LLC_MISSES         = 2, /*!< Last level cache misses              */
+  BRANCH_MISSES      = 3, /*!< Mispredicted branches                */
+  NB_HARDWARE_EVENTS = 4  /*!< Number of hardware events            */
+};
+
 
 #endif /* defined(__MoRIS__Enums__) */
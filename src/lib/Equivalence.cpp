@@ -0,0 +1,337 @@
+/**
+ * \file      Equivalence.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     Equivalence class definition
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "Equivalence.h"
+
+
+/*----------------------------
+ * CONSTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Constructor
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+Equivalence::Equivalence( void )
+{
+  /*--------------------------------------- NODES */
+  
+  _node_index.clear();
+  _value_index[0] = Graph::get_state_value_index("p_sim");
+  _value_index[1] = Graph::get_state_value_index("mean_nb_intros");
+  
+  /*--------------------------------------- SAMPLES */
+  
+  _reference_nodes.clear();
+  _candidate_nodes.clear();
+  _reference_scores.clear();
+  _candidate_scores.clear();
+}
+
+/*----------------------------
+ * DESTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Destructor
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+Equivalence::~Equivalence( void )
+{
+  _node_index.clear();
+  _reference_nodes.clear();
+  _candidate_nodes.clear();
+  _reference_scores.clear();
+  _candidate_scores.clear();
+}
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Add the final state of a run
+ * \details  The state is given as captured by Graph::capture_state(). Nodes are matched by identifier, so
+ *           that engines may store the nodes in different orders, but all the runs must have the same nodes.
+ * \param    bool candidate
+ * \param    const std::vector<int>& identifiers
+ * \param    const std::vector<double>& values
+ * \return   \e void
+ */
+void Equivalence::add_run( bool candidate, const std::vector<int>& identifiers, const std::vector<double>& values )
+{
+  assert(identifiers.size() > 0);
+  assert(values.size() == identifiers.size()*Graph::STATE_VALUES);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Index the nodes of the first run */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  if (_node_index.empty())
+  {
+    for (size_t i = 0; i < identifiers.size(); i++)
+    {
+      _node_index[identifiers[i]] = i;
+    }
+  }
+  if (identifiers.size() != _node_index.size())
+  {
+    std::cout << "Error: runs to compare do not have the same number of nodes.\n";
+    exit(EXIT_FAILURE);
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Save the node statistics         */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<double>& nodes = (candidate ? _candidate_nodes : _reference_nodes);
+  size_t               first = nodes.size();
+  nodes.resize(first+identifiers.size()*NB_NODE_STATISTICS, 0.0);
+  for (size_t i = 0; i < identifiers.size(); i++)
+  {
+    std::unordered_map<int, size_t>::const_iterator it = _node_index.find(identifiers[i]);
+    if (it == _node_index.end())
+    {
+      std::cout << "Error: node " << identifiers[i] << " is missing in the first run.\n";
+      exit(EXIT_FAILURE);
+    }
+    for (int s = 0; s < NB_NODE_STATISTICS; s++)
+    {
+      nodes[first+it->second*NB_NODE_STATISTICS+s] = values[i*Graph::STATE_VALUES+_value_index[s]];
+    }
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Save the score                   */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  double score = values[Graph::get_state_value_index("score")];
+  (candidate ? _candidate_scores : _reference_scores).push_back(score);
+}
+
+/**
+ * \brief    Test the equivalence of the reference and candidate runs
+ * \details  Each node statistic is compared node by node with a Mann-Whitney test. Nodes with the same
+ *           constant value in all the runs are not informative and are skipped. The statistic passes if the
+ *           fraction of nodes rejected at level alpha does not exceed alpha+tolerance. Scores are compared
+ *           with a Kolmogorov-Smirnov test, and pass if the p-value is at least alpha. Results are printed.
+ * \param    double alpha
+ * \param    double tolerance
+ * \return   \e bool
+ */
+bool Equivalence::test( double alpha, double tolerance )
+{
+  assert(alpha > 0.0 && alpha < 1.0);
+  assert(tolerance >= 0.0);
+  if (_reference_scores.size() < 2 || _candidate_scores.size() < 2)
+  {
+    std::cout << "Error: at least two reference and two candidate runs are needed.\n";
+    exit(EXIT_FAILURE);
+  }
+  bool pass = true;
+  pass = test_node_statistic(0, "p_sim", alpha, tolerance) && pass;
+  pass = test_node_statistic(1, "mean_nb_intros", alpha, tolerance) && pass;
+  double p_value = kolmogorov_smirnov_p_value(_reference_scores, _candidate_scores);
+  std::cout << "score: Kolmogorov-Smirnov p-value " << p_value << " (limit " << alpha << "): " << (p_value >= alpha ? "PASS" : "FAIL") << "\n";
+  return (p_value >= alpha) && pass;
+}
+
+/**
+ * \brief    Two-sided p-value of the Mann-Whitney U test
+ * \details  Normal approximation with tie and continuity corrections. Returns 1 if all the values are tied.
+ * \param    const std::vector<double>& sample1
+ * \param    const std::vector<double>& sample2
+ * \return   \e double
+ */
+double Equivalence::mann_whitney_p_value( const std::vector<double>& sample1, const std::vector<double>& sample2 )
+{
+  assert(sample1.size() > 0);
+  assert(sample2.size() > 0);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Rank the pooled values           */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  double n1 = (double)sample1.size();
+  double n2 = (double)sample2.size();
+  double n  = n1+n2;
+  std::vector< std::pair<double, int> > pooled;
+  pooled.reserve(sample1.size()+sample2.size());
+  for (size_t i = 0; i < sample1.size(); i++)
+  {
+    pooled.push_back(std::make_pair(sample1[i], 1));
+  }
+  for (size_t i = 0; i < sample2.size(); i++)
+  {
+    pooled.push_back(std::make_pair(sample2[i], 2));
+  }
+  std::sort(pooled.begin(), pooled.end());
+  double rank_sum = 0.0;
+  double ties     = 0.0;
+  size_t i        = 0;
+  while (i < pooled.size())
+  {
+    size_t j = i;
+    while (j < pooled.size() && pooled[j].first == pooled[i].first)
+    {
+      j++;
+    }
+    double t    = (double)(j-i);
+    double rank = (i+1+j)/2.0;
+    for (size_t k = i; k < j; k++)
+    {
+      rank_sum += (pooled[k].second == 1 ? rank : 0.0);
+    }
+    ties += t*t*t-t;
+    i     = j;
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Compute the p-value              */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  double u        = rank_sum-n1*(n1+1.0)/2.0;
+  double mean     = n1*n2/2.0;
+  double variance = n1*n2/12.0*((n+1.0)-ties/(n*(n-1.0)));
+  if (variance <= 0.0)
+  {
+    return 1.0;
+  }
+  double z = (fabs(u-mean)-0.5)/sqrt(variance);
+  z        = (z < 0.0 ? 0.0 : z);
+  return erfc(z/sqrt(2.0));
+}
+
+/**
+ * \brief    p-value of the two-sample Kolmogorov-Smirnov test
+ * \details  Asymptotic Kolmogorov distribution, with the small sample correction of Stephens (1970)
+ * \param    const std::vector<double>& sample1
+ * \param    const std::vector<double>& sample2
+ * \return   \e double
+ */
+double Equivalence::kolmogorov_smirnov_p_value( const std::vector<double>& sample1, const std::vector<double>& sample2 )
+{
+  assert(sample1.size() > 0);
+  assert(sample2.size() > 0);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Compute the distance D           */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<double> a = sample1;
+  std::vector<double> b = sample2;
+  std::sort(a.begin(), a.end());
+  std::sort(b.begin(), b.end());
+  double n1 = (double)a.size();
+  double n2 = (double)b.size();
+  double d  = 0.0;
+  size_t i  = 0;
+  size_t j  = 0;
+  while (i < a.size() && j < b.size())
+  {
+    double value = (a[i] < b[j] ? a[i] : b[j]);
+    while (i < a.size() && a[i] == value)
+    {
+      i++;
+    }
+    while (j < b.size() && b[j] == value)
+    {
+      j++;
+    }
+    d = std::max(d, fabs(i/n1-j/n2));
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Compute the p-value              */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  double en     = sqrt(n1*n2/(n1+n2));
+  double lambda = (en+0.12+0.11/en)*d;
+  if (lambda < 0.2)
+  {
+    return 1.0;
+  }
+  double p_value = 0.0;
+  double sign    = 1.0;
+  for (int k = 1; k <= 100; k++)
+  {
+    double term  = sign*exp(-2.0*k*k*lambda*lambda);
+    p_value     += term;
+    if (fabs(term) < 1e-12)
+    {
+      break;
+    }
+    sign = -sign;
+  }
+  p_value *= 2.0;
+  return (p_value < 0.0 ? 0.0 : (p_value > 1.0 ? 1.0 : p_value));
+}
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Test a node statistic, node by node
+ * \details  See test()
+ * \param    int statistic
+ * \param    std::string name
+ * \param    double alpha
+ * \param    double tolerance
+ * \return   \e bool
+ */
+bool Equivalence::test_node_statistic( int statistic, std::string name, double alpha, double tolerance )
+{
+  size_t              nb_nodes   = _node_index.size();
+  size_t              nb_ref     = _reference_scores.size();
+  size_t              nb_cand    = _candidate_scores.size();
+  int                 nb_tested  = 0;
+  int                 nb_reject  = 0;
+  std::vector<double> reference(nb_ref, 0.0);
+  std::vector<double> candidate(nb_cand, 0.0);
+  for (size_t node = 0; node < nb_nodes; node++)
+  {
+    bool constant = true;
+    for (size_t run = 0; run < nb_ref; run++)
+    {
+      reference[run] = _reference_nodes[(run*nb_nodes+node)*NB_NODE_STATISTICS+statistic];
+      constant       = constant && (reference[run] == reference[0]);
+    }
+    for (size_t run = 0; run < nb_cand; run++)
+    {
+      candidate[run] = _candidate_nodes[(run*nb_nodes+node)*NB_NODE_STATISTICS+statistic];
+      constant       = constant && (candidate[run] == reference[0]);
+    }
+    if (!constant)
+    {
+      nb_tested++;
+      nb_reject += (mann_whitney_p_value(reference, candidate) < alpha ? 1 : 0);
+    }
+  }
+  double fraction = (nb_tested > 0 ? nb_reject/(double)nb_tested : 0.0);
+  bool   pass     = (fraction <= alpha+tolerance);
+  std::cout << name << ": " << nb_reject << " of " << nb_tested << " informative nodes differ at level " << alpha << " (fraction " << fraction << ", limit " << alpha+tolerance << "): " << (pass ? "PASS" : "FAIL") << "\n";
+  return pass;
+}
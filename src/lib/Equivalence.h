@@ -0,0 +1,142 @@
+/**
+ * \file      Equivalence.h
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     Equivalence class declaration
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef __MoRIS__Equivalence__
+#define __MoRIS__Equivalence__
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "Graph.h"
+
+
+class Equivalence
+{
+  
+public:
+  
+  /*----------------------------
+   * CONSTRUCTORS
+   *----------------------------*/
+  Equivalence( void );
+  Equivalence( const Equivalence& equivalence ) = delete;
+  
+  /*----------------------------
+   * DESTRUCTORS
+   *----------------------------*/
+  ~Equivalence( void );
+  
+  /*----------------------------
+   * GETTERS
+   *----------------------------*/
+  inline int get_number_of_reference_runs( void ) const;
+  inline int get_number_of_candidate_runs( void ) const;
+  
+  /*----------------------------
+   * SETTERS
+   *----------------------------*/
+  Equivalence& operator=(const Equivalence&) = delete;
+  
+  /*----------------------------
+   * PUBLIC METHODS
+   *----------------------------*/
+  void add_run( bool candidate, const std::vector<int>& identifiers, const std::vector<double>& values );
+  bool test( double alpha, double tolerance );
+  
+  static double mann_whitney_p_value( const std::vector<double>& sample1, const std::vector<double>& sample2 );
+  static double kolmogorov_smirnov_p_value( const std::vector<double>& sample1, const std::vector<double>& sample2 );
+  
+  /*----------------------------
+   * PUBLIC ATTRIBUTES
+   *----------------------------*/
+  static const int NB_NODE_STATISTICS = 2; /*!< Number of compared node statistics (p_sim, mean_nb_intros) */
+  
+protected:
+  
+  /*----------------------------
+   * PROTECTED METHODS
+   *----------------------------*/
+  bool test_node_statistic( int statistic, std::string name, double alpha, double tolerance );
+  
+  /*----------------------------
+   * PROTECTED ATTRIBUTES
+   *----------------------------*/
+  
+  /*--------------------------------------- NODES */
+  
+  std::unordered_map<int, size_t> _node_index;                      /*!< Row of each node identifier (first capture order) */
+  int                             _value_index[NB_NODE_STATISTICS]; /*!< Index of each statistic in captured states         */
+  
+  /*--------------------------------------- SAMPLES */
+  
+  std::vector<double> _reference_nodes;  /*!< Node statistics of the reference runs (run, node, statistic) */
+  std::vector<double> _candidate_nodes;  /*!< Node statistics of the candidate runs (run, node, statistic) */
+  std::vector<double> _reference_scores; /*!< Score of each reference run                                 */
+  std::vector<double> _candidate_scores; /*!< Score of each candidate run                                 */
+  
+};
+
+
+/*----------------------------
+ * GETTERS
+ *----------------------------*/
+
+/**
+ * \brief    Get the number of reference runs
+ * \details  --
+ * \param    void
+ * \return   \e int
+ */
+inline int Equivalence::get_number_of_reference_runs( void ) const
+{
+  return (int)_reference_scores.size();
+}
+
+/**
+ * \brief    Get the number of candidate runs
+ * \details  --
+ * \param    void
+ * \return   \e int
+ */
+inline int Equivalence::get_number_of_candidate_runs( void ) const
+{
+  return (int)_candidate_scores.size();
+}
+
+/*----------------------------
+ * SETTERS
+ *----------------------------*/
+
+
+#endif /* defined(__MoRIS__Equivalence__) */
@@ -28,6 +28,14 @@
 
 #include "Graph.h"
 
+const char* const Graph::STATE_NAMES[Graph::STATE_VALUES] =
+{
+  "x", "y", "y_obs", "n_obs", "p_obs", "total_nb_intros", "mean_nb_intros", "var_nb_intros", "y_sim", "n_sim", "p_sim",
+  "mean_first_invasion", "var_first_invasion", "mean_last_invasion", "var_last_invasion",
+  "q05_first_invasion", "median_first_invasion", "q95_first_invasion", "q05_last_invasion", "median_last_invasion", "q95_last_invasion",
+  "node_score", "L", "empty_L", "max_L", "empty_score", "score"
+};
+
 
 /*----------------------------
  * CONSTRUCTORS
@@ -48,9 +56,21 @@ Graph::Graph( Parameters* parameters )
   
   /*--------------------------------------- GRAPH STRUCTURE */
   
-  load_map();
-  load_network();
+  _next_node = 0;
+  _nb_edges  = 0;
+  if (_parameters->get_node_order() == DEFAULT_ORDER)
+  {
+    load_map();
+    load_network();
+  }
+  else
+  {
+    load_ordered_graph();
+  }
+  choose_state_layout();
+  allocate_states();
   load_sample();
+  build_spatial_index();
   
   /*--------------------------------------- GRAPH STATISTICS */
   
@@ -59,6 +79,14 @@ Graph::Graph( Parameters* parameters )
   compute_human_activity_index();
   reset_states();
   set_introduction_node();
+  initialize_time_series();
+  
+  /*--------------------------------------- DERIVED DATA INPUTS */
+  
+  save_road_weights();
+  _x_introduction       = _parameters->get_x_introduction();
+  _y_introduction       = _parameters->get_y_introduction();
+  _human_activity_index = _parameters->get_human_activity_index();
   
   /*--------------------------------------- MINIMIZATION SCORE */
   
@@ -88,12 +116,69 @@ Graph::~Graph( void )
     it->second = NULL;
   }
   _map.clear();
+  _nodes.clear();
+  delete _spatial_index;
+  _spatial_index = NULL;
 }
 
 /*----------------------------
  * PUBLIC METHODS
  *----------------------------*/
 
+/**
+ * \brief    Reinitialize the graph with the current parameters
+ * \details  Derived data are only recomputed when the parameters they depend on changed since the last build:
+ *           edge weights (w1-w6, wmin), the introduction node (xintro, yintro) and the human activity index
+ *           (humanactivity). Node states are always reset. The map, network and sample files are not reloaded,
+ *           and the number of repetitions must not change.
+ * \param    void
+ * \return   \e void
+ */
+void Graph::reinitialize( void )
+{
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Recompute edge weights                 */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  if (road_weights_changed())
+  {
+    Node* node = get_first();
+    while (node != NULL)
+    {
+      node->compute_weights();
+      node = get_next();
+    }
+    compute_statistics();
+    save_road_weights();
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Find the introduction node             */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  if (_x_introduction != _parameters->get_x_introduction() || _y_introduction != _parameters->get_y_introduction())
+  {
+    _introduction_node = get_introduction_node_from_coordinates();
+    _x_introduction    = _parameters->get_x_introduction();
+    _y_introduction    = _parameters->get_y_introduction();
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Compute the human activity index       */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  if (_human_activity_index != _parameters->get_human_activity_index())
+  {
+    compute_human_activity_index();
+    _human_activity_index = _parameters->get_human_activity_index();
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 4) Reset the states                       */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  reset_states();
+  set_introduction_node();
+  initialize_time_series();
+  compute_score(true);
+}
+
 /**
  * \brief    Untag all the nodes
  * \details  --
@@ -112,17 +197,20 @@ void Graph::untag( void )
 
 /**
  * \brief    Update all the node states
- * \details  --
+ * \details  The state layout is tested once, and the pass runs in the kernel of this layout (see
+ *           update_node_states())
  * \param    void
  * \return   \e void
  */
 void Graph::update_state( void )
 {
-  Node* node = get_first();
-  while (node != NULL)
+  if (_parameters->get_state_layout() == COMPACT_LAYOUT)
   {
-    node->update_state();
-    node = get_next();
+    update_node_states<COMPACT_LAYOUT>();
+  }
+  else
+  {
+    update_node_states<STANDARD_LAYOUT>();
   }
 }
 
@@ -182,73 +270,206 @@ void Graph::compute_score( bool empty )
 }
 
 /**
- * \brief    Write node set state
+ * \brief    Write the current state
  * \details  --
  * \param    std::string filename
  * \return   \e void
  */
 void Graph::write_state( std::string filename )
 {
-  std::ofstream file(filename, std::ios::out | std::ios::trunc);
-  file << "id x y y_obs n_obs p_obs total_nb_intros mean_nb_intros var_nb_intros y_sim n_sim p_sim mean_first_invasion var_first_invasion mean_last_invasion var_last_invasion L empty_L max_L empty_score score\n";
-  Node* node = get_first();
+  std::vector<int>    identifiers;
+  std::vector<double> values;
+  capture_state(identifiers, values);
+  write_captured_state(filename, identifiers, values);
+}
+
+/**
+ * \brief    Capture the current state
+ * \details  Node identifiers are saved in iteration order, with STATE_VALUES values by node (see write_state).
+ *           Invasion age quantiles (5%, 50% and 95%) are computed over the invaded repetitions.
+ * \param    std::vector<int>& identifiers
+ * \param    std::vector<double>& values
+ * \return   \e void
+ */
+void Graph::capture_state( std::vector<int>& identifiers, std::vector<double>& values )
+{
+  const double        probabilities[3] = {0.05, 0.5, 0.95};
+  std::vector<double> buffer;
+  buffer.reserve(_parameters->get_repetitions());
+  identifiers.resize(_map.size());
+  values.resize(_map.size()*STATE_VALUES);
+  size_t index = 0;
+  double* v    = values.data();
+  Node*   node = get_first();
   while (node != NULL)
   {
-    file << node->get_identifier() << " ";
-    file << node->get_x() << " ";
-    file << node->get_y() << " ";
-    file << node->get_y_obs() << " ";
-    file << node->get_n_obs() << " ";
-    file << node->get_p_obs() << " ";
-    file << node->get_total_nb_introductions() << " ";
-    file << node->get_mean_nb_introductions() << " ";
-    file << node->get_var_nb_introductions() << " ";
-    file << node->get_y_sim() << " ";
-    file << node->get_n_sim() << " ";
-    file << node->get_p_sim() << " ";
-    file << node->get_mean_first_invasion_age() << " ";
-    file << node->get_var_first_invasion_age() << " ";
-    file << node->get_mean_last_invasion_age() << " ";
-    file << node->get_var_last_invasion_age() << " ";
-    file << _total_log_likelihood << " ";
-    file << _total_log_empty_likelihood << " ";
-    file << _total_log_maximum_likelihood << " ";
-    file << _empty_score << " ";
-    file << _score << "\n";
+    identifiers[index++] = node->get_identifier();
+    *v++ = node->get_x();
+    *v++ = node->get_y();
+    *v++ = node->get_y_obs();
+    *v++ = node->get_n_obs();
+    *v++ = node->get_p_obs();
+    *v++ = node->get_total_nb_introductions();
+    *v++ = node->get_mean_nb_introductions();
+    *v++ = node->get_var_nb_introductions();
+    *v++ = node->get_y_sim();
+    *v++ = node->get_n_sim();
+    *v++ = node->get_p_sim();
+    *v++ = node->get_mean_first_invasion_age();
+    *v++ = node->get_var_first_invasion_age();
+    *v++ = node->get_mean_last_invasion_age();
+    *v++ = node->get_var_last_invasion_age();
+    node->compute_invasion_age_quantiles(probabilities, 3, v, v+3, buffer);
+    v   += 6;
+    *v++ = compute_node_score(node);
+    *v++ = _total_log_likelihood;
+    *v++ = _total_log_empty_likelihood;
+    *v++ = _total_log_maximum_likelihood;
+    *v++ = _empty_score;
+    *v++ = _score;
     node = get_next();
   }
+}
+
+/**
+ * \brief    Write a captured state
+ * \details  Does not access the graph, so a state can be written while the simulation goes on
+ * \param    std::string filename
+ * \param    const std::vector<int>& identifiers
+ * \param    const std::vector<double>& values
+ * \return   \e void
+ */
+void Graph::write_captured_state( std::string filename, const std::vector<int>& identifiers, const std::vector<double>& values )
+{
+  assert(values.size() == identifiers.size()*STATE_VALUES);
+  TextWriter file(filename);
+  file << "id";
+  for (int j = 0; j < STATE_VALUES; j++)
+  {
+    file << ' ' << STATE_NAMES[j];
+  }
+  file << '\n';
+  const double* v = values.data();
+  for (size_t i = 0; i < identifiers.size(); i++)
+  {
+    file << identifiers[i];
+    for (int j = 0; j < STATE_VALUES; j++)
+    {
+      file << ' ' << *v++;
+    }
+    file << '\n';
+  }
   file.close();
 }
 
 /**
- * \brief    Write the euclidean distance distribution of invaded nodes (simulated or observed)
- * \details  --
+ * \brief    Get the index of a state value from its name
+ * \details  Returns -1 if the name is unknown (see STATE_NAMES)
+ * \param    std::string name
+ * \return   \e int
+ */
+int Graph::get_state_value_index( std::string name )
+{
+  for (int j = 0; j < STATE_VALUES; j++)
+  {
+    if (name == STATE_NAMES[j])
+    {
+      return j;
+    }
+  }
+  return -1;
+}
+
+/**
+ * \brief    Estimate the memory footprint of a simulation, in bytes
+ * \details  The node states take nb_nodes x repetitions x Node::get_bytes_by_repetition(layout) bytes. The
+ *           estimate adds the nodes and their hash map entries, the neighbors and road lengths of each edge
+ *           (stored by both ends), the spatial index and, when outputs are saved, the invasion time series.
+ *           The input files read in memory to compute a node order (see load_ordered_graph()) are freed
+ *           before the node states are allocated, and are not counted.
+ * \param    Parameters* parameters
+ * \param    state_layout layout
+ * \param    int nb_nodes
+ * \param    int nb_edges
+ * \return   \e double
+ */
+double Graph::estimate_memory( Parameters* parameters, state_layout layout, int nb_nodes, int nb_edges )
+{
+  double nb_reps  = (double)parameters->get_repetitions();
+  double by_node  = (double)sizeof(Node)+64.0+32.0+5.0*16.0;
+  double by_edge  = 2.0*(sizeof(Node*)+7.0*sizeof(double));
+  double states   = (double)nb_nodes*nb_reps*(double)Node::get_bytes_by_repetition(layout);
+  double series   = (parameters->saveOutputs() ? 4.0*nb_reps*(parameters->get_iterations()+1.0)*sizeof(double) : 0.0);
+  return states+nb_nodes*by_node+nb_edges*by_edge+series;
+}
+
+/**
+ * \brief    Write the euclidean distance histograms of invaded node pairs (simulated or observed)
+ * \details  Distances between unique pairs of invaded nodes are binned in nb_bins bins spanning the map diagonal.
+ *           Observed pairs are weighted by the number of observations of the first node. Simulated
+ *           histograms are computed by repetition in parallel, only iterating over occupied nodes.
+ *           Empty bins are not written.
  * \param    std::string observed_filename
  * \param    std::string simulated_filename
+ * \param    int nb_bins
  * \return   \e void
  */
-void Graph::write_invasion_euclidean_distributions( std::string observed_filename, std::string simulated_filename )
+void Graph::write_invasion_euclidean_distributions( std::string observed_filename, std::string simulated_filename, int nb_bins )
 {
+  assert(nb_bins > 0);
+  
   /*~~~~~~~~~~~~~~~~~~~~~~~*/
-  /* 1) Observed invasion  */
+  /* 1) Define the bins    */
   /*~~~~~~~~~~~~~~~~~~~~~~~*/
-  std::ofstream file(observed_filename, std::ios::out | std::ios::trunc);
-  file << "start_node end_node euclidean_dist\n";
-  for (std::unordered_map<int, Node*>::iterator it1 = _map.begin(); it1 != _map.end(); ++it1)
+  std::vector<Node*> nodes;
+  nodes.reserve(_map.size());
+  double xmin = 0.0;
+  double xmax = 0.0;
+  double ymin = 0.0;
+  double ymax = 0.0;
+  for (std::unordered_map<int, Node*>::iterator it = _map.begin(); it != _map.end(); ++it)
   {
-    for (std::unordered_map<int, Node*>::iterator it2 = _map.find(it1->first); it2 != _map.end(); ++it2)
+    Node* node = it->second;
+    if (nodes.size() == 0)
     {
-      if (it1->first != it2->first)
-      {
-        double dist = compute_euclidean_distance(it1->second, it2->second);
-        if (it1->second->get_y_obs() > 0.0 && it2->second->get_y_obs() > 0.0)
-        {
-          for (double i = 0; i < it1->second->get_y_obs(); i++)
-          {
-            file << it1->first << " " << it2->first << " " << dist << "\n";
-          }
-        }
-      }
+      xmin = xmax = node->get_x();
+      ymin = ymax = node->get_y();
+    }
+    xmin = (node->get_x() < xmin ? node->get_x() : xmin);
+    xmax = (node->get_x() > xmax ? node->get_x() : xmax);
+    ymin = (node->get_y() < ymin ? node->get_y() : ymin);
+    ymax = (node->get_y() > ymax ? node->get_y() : ymax);
+    nodes.push_back(node);
+  }
+  double diagonal  = sqrt((xmax-xmin)*(xmax-xmin) + (ymax-ymin)*(ymax-ymin));
+  double bin_width = (diagonal > 0.0 ? diagonal/(double)nb_bins : 1.0);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Observed invasion  */
+  /*~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<Node*> observed;
+  for (size_t i = 0; i < nodes.size(); i++)
+  {
+    if (nodes[i]->get_y_obs() > 0.0)
+    {
+      observed.push_back(nodes[i]);
+    }
+  }
+  std::vector<double> counts(nb_bins, 0.0);
+  for (size_t i = 0; i < observed.size(); i++)
+  {
+    for (size_t j = i+1; j < observed.size(); j++)
+    {
+      counts[get_distance_bin(compute_euclidean_distance(observed[i], observed[j]), bin_width, nb_bins)] += ceil(observed[i]->get_y_obs());
+    }
+  }
+  TextWriter file(observed_filename);
+  file << "lower_bound upper_bound count\n";
+  for (int bin = 0; bin < nb_bins; bin++)
+  {
+    if (counts[bin] > 0.0)
+    {
+      file << bin*bin_width << " " << (bin+1)*bin_width << " " << counts[bin] << "\n";
     }
   }
   file.close();
@@ -256,61 +477,142 @@ void Graph::write_invasion_euclidean_distributions( std::string observed_filenam
   /*~~~~~~~~~~~~~~~~~~~~~~~*/
   /* 3) Simulated invasion */
   /*~~~~~~~~~~~~~~~~~~~~~~~*/
-  file.open(simulated_filename, std::ios::out | std::ios::trunc);
-  file << "start_node end_node euclidean_dist rep\n";
-  for (std::unordered_map<int, Node*>::iterator it1 = _map.begin(); it1 != _map.end(); ++it1)
+  int nb_reps    = _parameters->get_repetitions();
+  int nb_threads = (int)std::thread::hardware_concurrency();
+  nb_threads     = (nb_threads < 1 ? 1 : (nb_threads > nb_reps ? nb_reps : nb_threads));
+  counts.assign((size_t)nb_reps*nb_bins, 0.0);
+  std::vector<std::thread> workers;
+  for (int thread = 0; thread < nb_threads; thread++)
+  {
+    workers.push_back(std::thread(&Graph::compute_simulated_euclidean_histograms, this, std::cref(nodes), bin_width, nb_bins, thread, nb_threads, std::ref(counts)));
+  }
+  for (size_t thread = 0; thread < workers.size(); thread++)
+  {
+    workers[thread].join();
+  }
+  file.open(simulated_filename);
+  file << "lower_bound upper_bound count rep\n";
+  for (int rep = 0; rep < nb_reps; rep++)
   {
-    for (std::unordered_map<int, Node*>::iterator it2 = _map.find(it1->first); it2 != _map.end(); ++it2)
+    for (int bin = 0; bin < nb_bins; bin++)
     {
-      if (it1->first != it2->first)
+      if (counts[(size_t)rep*nb_bins+bin] > 0.0)
       {
-        double dist = compute_euclidean_distance(it1->second, it2->second);
-        for (int i = 0; i < _parameters->get_repetitions(); i++)
-        {
-          if (it1->second->isOccupied(i) && it2->second->isOccupied(i))
-          {
-            file << it1->first << " " << it2->first << " " << dist << " " << i+1 << "\n";
-          }
-        }
+        file << bin*bin_width << " " << (bin+1)*bin_width << " " << counts[(size_t)rep*nb_bins+bin] << " " << rep+1 << "\n";
       }
     }
   }
   file.close();
 }
 
-/*----------------------------
- * PROTECTED METHODS
- *----------------------------*/
+/**
+ * \brief    Write the invasion time series
+ * \details  One line by iteration and repetition, from the initial state (iteration 0) to the current one.
+ *           Gives the number of invaded nodes, the number of new introductions during the iteration, and
+ *           the maximum and mean euclidean distances of invaded nodes from the introduction node.
+ *           Only recorded when outputs are saved.
+ * \param    std::string filename
+ * \return   \e void
+ */
+void Graph::write_invasion_time_series( std::string filename )
+{
+  int nb_reps = _parameters->get_repetitions();
+  assert(_time_series.size()%(4*nb_reps) == 0);
+  TextWriter file(filename);
+  file << "iteration rep nb_invaded nb_new_intros max_euclidean_dist mean_euclidean_dist\n";
+  const double* row = _time_series.data();
+  for (size_t iteration = 0; iteration < _time_series.size()/(4*nb_reps); iteration++)
+  {
+    for (int rep = 0; rep < nb_reps; rep++)
+    {
+      file << (unsigned long)iteration << ' ' << rep+1 << ' ' << row[0] << ' ' << row[1] << ' ' << row[2] << ' ' << row[3] << '\n';
+      row += 4;
+    }
+  }
+  file.close();
+}
 
 /**
- * \brief    Get the introduction node from the coordinates
- * \details  --
- * \param    void
+ * \brief    Write the node states in a binary checkpoint file
+ * \details  Writes the number of nodes, then the identifier and simulation variables of each node (see
+ *           Node::write_checkpoint()), then the invasion time series
+ * \param    std::ofstream& file
  * \return   \e void
  */
-int Graph::get_introduction_node_from_coordinates( void )
+void Graph::write_checkpoint( std::ofstream& file )
 {
-  double x_intro   = _parameters->get_x_introduction();
-  double y_intro   = _parameters->get_y_introduction();
-  double min_dist  = 1e+10;
-  int    min_intro = 0;
-  Node*  node      = get_first();
+  uint64_t nb_nodes = (uint64_t)_map.size();
+  file.write((const char*)&nb_nodes, sizeof(uint64_t));
+  Node* node = get_first();
   while (node != NULL)
   {
-    double dist = sqrt((x_intro-node->get_x())*(x_intro-node->get_x()) + (y_intro-node->get_y())*(y_intro-node->get_y()));
-    if (min_dist > dist)
+    int32_t identifier = (int32_t)node->get_identifier();
+    file.write((const char*)&identifier, sizeof(int32_t));
+    node->write_checkpoint(file);
+    node = get_next();
+  }
+  uint64_t sizes[3] = {(uint64_t)_time_series.size(), (uint64_t)_time_series_row.size(), (uint64_t)_time_series_intros.size()};
+  file.write((const char*)sizes, sizeof(sizes));
+  file.write((const char*)_time_series.data(), _time_series.size()*sizeof(double));
+  file.write((const char*)_time_series_row.data(), _time_series_row.size()*sizeof(double));
+  file.write((const char*)_time_series_intros.data(), _time_series_intros.size()*sizeof(double));
+}
+
+/**
+ * \brief    Read the node states from a binary checkpoint file
+ * \details  The checkpoint must come from the same map (see write_checkpoint())
+ * \param    std::ifstream& file
+ * \return   \e void
+ */
+void Graph::read_checkpoint( std::ifstream& file )
+{
+  uint64_t nb_nodes = 0;
+  file.read((char*)&nb_nodes, sizeof(uint64_t));
+  if (!file || nb_nodes != (uint64_t)_map.size())
+  {
+    std::cout << "Error: the checkpoint does not match the map (wrong number of cells).\n";
+    exit(EXIT_FAILURE);
+  }
+  for (uint64_t i = 0; i < nb_nodes; i++)
+  {
+    int32_t identifier = 0;
+    file.read((char*)&identifier, sizeof(int32_t));
+    Node* node = get_node((int)identifier);
+    if (!file || node == NULL)
     {
-      min_dist  = dist;
-      min_intro = node->get_identifier();
+      std::cout << "Error: the checkpoint does not match the map (unknown cell " << identifier << ").\n";
+      exit(EXIT_FAILURE);
     }
-    node = get_next();
+    node->read_checkpoint(file);
   }
-  return min_intro;
+  uint64_t sizes[3] = {0, 0, 0};
+  file.read((char*)sizes, sizeof(sizes));
+  _time_series.resize((size_t)sizes[0]);
+  _time_series_row.resize((size_t)sizes[1]);
+  _time_series_intros.resize((size_t)sizes[2]);
+  file.read((char*)_time_series.data(), _time_series.size()*sizeof(double));
+  file.read((char*)_time_series_row.data(), _time_series_row.size()*sizeof(double));
+  file.read((char*)_time_series_intros.data(), _time_series_intros.size()*sizeof(double));
+}
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Get the introduction node from the coordinates
+ * \details  Nearest node from (xintro, yintro), found with the spatial index
+ * \param    void
+ * \return   \e int
+ */
+int Graph::get_introduction_node_from_coordinates( void )
+{
+  return get_nearest_node(_parameters->get_x_introduction(), _parameters->get_y_introduction())->get_identifier();
 }
 
 /**
  * \brief    Load the map from file
- * \details  --
+ * \details  Nodes are allocated in the map file order, and visited in the order of the nodes map
  * \param    void
  * \return   \e void
  */
@@ -338,6 +640,12 @@ void Graph::load_map( void )
     _map[identifier]->set_map_data(x_coord, y_coord, node_area, suitable_area, population, population_density, road_density);
   }
   file.close();
+  _nodes.clear();
+  _nodes.reserve(_map.size());
+  for (std::unordered_map<int, Node*>::iterator it = _map.begin(); it != _map.end(); ++it)
+  {
+    _nodes.push_back(it->second);
+  }
 }
 
 /**
@@ -358,48 +666,349 @@ void Graph::load_network( void )
     flux.str(line.c_str());
     int    identifier1 = 0;
     int    identifier2 = 0;
-    double roads1      = 0.0;
-    double roads2      = 0.0;
-    double roads3      = 0.0;
-    double roads4      = 0.0;
-    double roads5      = 0.0;
-    double roads6      = 0.0;
-    flux >> identifier1 >> identifier2 >> roads1 >> roads2 >> roads3 >> roads4 >> roads5 >> roads6;
-    assert(roads1 >= 0.0);
-    assert(roads2 >= 0.0);
-    assert(roads3 >= 0.0);
-    assert(roads4 >= 0.0);
-    assert(roads5 >= 0.0);
-    assert(roads6 >= 0.0);
-    double weight  = 0.0;
-    weight        += _parameters->get_w1()*roads1;
-    weight        += _parameters->get_w2()*roads2;
-    weight        += _parameters->get_w3()*roads3;
-    weight        += _parameters->get_w4()*roads4;
-    weight        += _parameters->get_w5()*roads5;
-    weight        += _parameters->get_w6()*roads6;
-    weight         = (weight < _parameters->get_wmin() ? _parameters->get_wmin() : weight);
+    double roads[6]    = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    flux >> identifier1 >> identifier2 >> roads[0] >> roads[1] >> roads[2] >> roads[3] >> roads[4] >> roads[5];
+    _nb_edges++;
     if (identifier1 != -1 && identifier2 != -1)
     {
       assert(_map.find(identifier1) != _map.end());
       assert(_map.find(identifier2) != _map.end());
-      _map[identifier1]->add_neighbor(weight, _map[identifier2]);
-      _map[identifier2]->add_neighbor(weight, _map[identifier1]);
+      _map[identifier1]->add_neighbor(roads, _map[identifier2]);
+      _map[identifier2]->add_neighbor(roads, _map[identifier1]);
     }
     else if (identifier1 != -1 && identifier2 == -1)
     {
       assert(_map.find(identifier1) != _map.end());
-      _map[identifier1]->add_neighbor(weight, NULL);
+      _map[identifier1]->add_neighbor(roads, NULL);
     }
     else if (identifier1 == -1 && identifier2 != -1)
     {
       assert(_map.find(identifier2) != _map.end());
-      _map[identifier2]->add_neighbor(weight, NULL);
+      _map[identifier2]->add_neighbor(roads, NULL);
     }
   }
   file.close();
 }
 
+/**
+ * \brief    Load the map and the network from file, in the node order of the parameters
+ * \details  Both files are first read in memory to compute the node order (see compute_hilbert_order() and
+ *           compute_rcm_order()). The nodes and their network arrays are then allocated in this order, which
+ *           is also the order of the simulation loop, so that nodes close on the map or in the network are
+ *           close in memory (repetition arrays follow the same order, see allocate_states()). The nodes map
+ *           is filled in the map file order, as in load_map(), so that the nodes map order (and the spatial
+ *           index) do not depend on the node order.
+ * \param    void
+ * \return   \e void
+ */
+void Graph::load_ordered_graph( void )
+{
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Read the map and the network           */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<int>    identifiers;
+  std::vector<double> map_data;
+  std::vector<int>    edges;
+  std::vector<double> roads;
+  std::ifstream       file(_parameters->get_map_filename(), std::ios::in);
+  assert(file);
+  std::string line;
+  while(getline(file, line))
+  {
+    std::stringstream flux;
+    flux.str(line.c_str());
+    int    identifier = 0;
+    double values[7]  = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    flux >> identifier >> values[0] >> values[1] >> values[2] >> values[3] >> values[4] >> values[5] >> values[6];
+    identifiers.push_back(identifier);
+    map_data.insert(map_data.end(), values, values+7);
+  }
+  file.close();
+  file.open(_parameters->get_network_filename(), std::ios::in);
+  assert(file);
+  while(getline(file, line))
+  {
+    std::stringstream flux;
+    flux.str(line.c_str());
+    int    identifier1 = 0;
+    int    identifier2 = 0;
+    double values[6]   = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    flux >> identifier1 >> identifier2 >> values[0] >> values[1] >> values[2] >> values[3] >> values[4] >> values[5];
+    edges.push_back(identifier1);
+    edges.push_back(identifier2);
+    roads.insert(roads.end(), values, values+6);
+  }
+  file.close();
+  _nb_edges = (int)edges.size()/2;
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Compute the node order                 */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<size_t> order;
+  if (_parameters->get_node_order() == HILBERT_ORDER)
+  {
+    compute_hilbert_order(map_data, order);
+  }
+  else
+  {
+    compute_rcm_order(identifiers, edges, order);
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Allocate the nodes in this order       */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::unordered_map<int, int> degrees;
+  for (size_t i = 0; i < edges.size(); i++)
+  {
+    degrees[edges[i]]++;
+  }
+  std::vector<Node*> nodes(identifiers.size(), NULL);
+  _nodes.clear();
+  _nodes.reserve(identifiers.size());
+  for (size_t i = 0; i < order.size(); i++)
+  {
+    int           identifier = identifiers[order[i]];
+    const double* values     = &map_data[7*order[i]];
+    Node*         node       = new Node(_parameters, identifier);
+    node->set_map_data(values[0], values[1], values[2], values[3], values[4], values[5], values[6]);
+    node->reserve_neighbors(degrees[identifier]);
+    nodes[order[i]] = node;
+    _nodes.push_back(node);
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 4) Fill the nodes map in the file order   */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  _map.clear();
+  for (size_t i = 0; i < identifiers.size(); i++)
+  {
+    assert(_map.find(identifiers[i]) == _map.end());
+    _map[identifiers[i]] = nodes[i];
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 5) Add the roads (as in load_network())   */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  for (size_t i = 0; i < edges.size()/2; i++)
+  {
+    int     identifier1 = edges[2*i];
+    int     identifier2 = edges[2*i+1];
+    double* values      = &roads[6*i];
+    if (identifier1 != -1 && identifier2 != -1)
+    {
+      assert(_map.find(identifier1) != _map.end());
+      assert(_map.find(identifier2) != _map.end());
+      _map[identifier1]->add_neighbor(values, _map[identifier2]);
+      _map[identifier2]->add_neighbor(values, _map[identifier1]);
+    }
+    else if (identifier1 != -1 && identifier2 == -1)
+    {
+      assert(_map.find(identifier1) != _map.end());
+      _map[identifier1]->add_neighbor(values, NULL);
+    }
+    else if (identifier1 == -1 && identifier2 != -1)
+    {
+      assert(_map.find(identifier2) != _map.end());
+      _map[identifier2]->add_neighbor(values, NULL);
+    }
+  }
+}
+
+/**
+ * \brief    Choose the state layout once the graph structure is loaded
+ * \details  The memory footprint is only estimated with a memory budget or the AUTO layout (see
+ *           estimate_memory()). AUTO keeps the standard layout if it fits in the budget (or without budget),
+ *           else chooses the compact layout. The simulation is refused if the chosen layout exceeds the budget.
+ * \param    void
+ * \return   \e void
+ */
+void Graph::choose_state_layout( void )
+{
+  double budget = _parameters->get_memory_budget();
+  if (budget == 0.0)
+  {
+    if (_parameters->get_state_layout() == AUTO_LAYOUT)
+    {
+      _parameters->set_state_layout(STANDARD_LAYOUT);
+    }
+    return;
+  }
+  int    nb_nodes = get_number_of_nodes();
+  double standard = estimate_memory(_parameters, STANDARD_LAYOUT, nb_nodes, _nb_edges)/1048576.0;
+  if (_parameters->get_state_layout() == AUTO_LAYOUT)
+  {
+    _parameters->set_state_layout(standard <= budget ? STANDARD_LAYOUT : COMPACT_LAYOUT);
+  }
+  double chosen = (_parameters->get_state_layout() == COMPACT_LAYOUT ? estimate_memory(_parameters, COMPACT_LAYOUT, nb_nodes, _nb_edges)/1048576.0 : standard);
+  if (chosen > budget)
+  {
+    std::cout << "Error: the simulation needs about " << chosen << " MB with the " << (_parameters->get_state_layout() == COMPACT_LAYOUT ? "COMPACT" : "STANDARD") << " layout, more than the memory budget (" << budget << " MB). Reduce -reps or raise -memory-budget.\n";
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * \brief    Allocate the node states in the order of the simulation loop
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void Graph::allocate_states( void )
+{
+  for (size_t i = 0; i < _nodes.size(); i++)
+  {
+    _nodes[i]->allocate_states();
+  }
+}
+
+/**
+ * \brief    Compute the Hilbert curve order of the map rows
+ * \details  Coordinates are scaled on a 65536 x 65536 grid covering the map, and rows are sorted by their
+ *           distance along the Hilbert curve of this grid (ties keep the map file order)
+ * \param    const std::vector<double>& map_data
+ * \param    std::vector<size_t>& order
+ * \return   \e void
+ */
+void Graph::compute_hilbert_order( const std::vector<double>& map_data, std::vector<size_t>& order )
+{
+  const uint32_t side    = 65536;
+  size_t         nb_rows = map_data.size()/7;
+  order.resize(nb_rows);
+  if (nb_rows == 0)
+  {
+    return;
+  }
+  double xmin = map_data[0];
+  double xmax = map_data[0];
+  double ymin = map_data[1];
+  double ymax = map_data[1];
+  for (size_t i = 0; i < nb_rows; i++)
+  {
+    xmin = std::min(xmin, map_data[7*i]);
+    xmax = std::max(xmax, map_data[7*i]);
+    ymin = std::min(ymin, map_data[7*i+1]);
+    ymax = std::max(ymax, map_data[7*i+1]);
+  }
+  std::vector<uint64_t> distances(nb_rows);
+  for (size_t i = 0; i < nb_rows; i++)
+  {
+    uint32_t x = (xmax > xmin ? (uint32_t)((map_data[7*i]-xmin)/(xmax-xmin)*(side-1)) : 0);
+    uint32_t y = (ymax > ymin ? (uint32_t)((map_data[7*i+1]-ymin)/(ymax-ymin)*(side-1)) : 0);
+    uint64_t d = 0;
+    for (uint32_t s = side/2; s > 0; s /= 2)
+    {
+      uint32_t rx = ((x & s) > 0);
+      uint32_t ry = ((y & s) > 0);
+      d += (uint64_t)s*s*((3*rx)^ry);
+      if (ry == 0)
+      {
+        if (rx == 1)
+        {
+          x = side-1-x;
+          y = side-1-y;
+        }
+        std::swap(x, y);
+      }
+    }
+    distances[i] = d;
+    order[i]     = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&distances]( size_t a, size_t b )
+  {
+    return distances[a] < distances[b];
+  });
+}
+
+/**
+ * \brief    Compute the reverse Cuthill-McKee order of the map rows
+ * \details  Each connected component of the network is visited breadth-first from one of its nodes of
+ *           minimum degree, neighbors being visited by increasing degree. The visit order is then reversed.
+ *           Roads leaving the map are ignored. Ties keep the order of the input files.
+ * \param    const std::vector<int>& identifiers
+ * \param    const std::vector<int>& edges
+ * \param    std::vector<size_t>& order
+ * \return   \e void
+ */
+void Graph::compute_rcm_order( const std::vector<int>& identifiers, const std::vector<int>& edges, std::vector<size_t>& order )
+{
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Build the adjacency lists of the rows  */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  size_t                       nb_rows = identifiers.size();
+  std::unordered_map<int, int> rows;
+  for (size_t i = 0; i < nb_rows; i++)
+  {
+    rows[identifiers[i]] = (int)i;
+  }
+  std::vector<size_t> first(nb_rows+1, 0);
+  for (size_t i = 0; i < edges.size(); i += 2)
+  {
+    if (edges[i] != -1 && edges[i+1] != -1)
+    {
+      first[rows[edges[i]]+1]++;
+      first[rows[edges[i+1]]+1]++;
+    }
+  }
+  for (size_t i = 0; i < nb_rows; i++)
+  {
+    first[i+1] += first[i];
+  }
+  std::vector<int>    adjacency(first[nb_rows]);
+  std::vector<size_t> next(first.begin(), first.end()-1);
+  for (size_t i = 0; i < edges.size(); i += 2)
+  {
+    if (edges[i] != -1 && edges[i+1] != -1)
+    {
+      int row1 = rows[edges[i]];
+      int row2 = rows[edges[i+1]];
+      adjacency[next[row1]++] = row2;
+      adjacency[next[row2]++] = row1;
+    }
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Visit the components breadth-first     */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<size_t> starts(nb_rows);
+  for (size_t i = 0; i < nb_rows; i++)
+  {
+    starts[i] = i;
+  }
+  auto by_degree = [&first]( size_t a, size_t b )
+  {
+    return first[a+1]-first[a] < first[b+1]-first[b];
+  };
+  std::stable_sort(starts.begin(), starts.end(), by_degree);
+  std::vector<bool> visited(nb_rows, false);
+  order.clear();
+  order.reserve(nb_rows);
+  for (size_t s = 0; s < nb_rows; s++)
+  {
+    if (visited[starts[s]])
+    {
+      continue;
+    }
+    visited[starts[s]] = true;
+    order.push_back(starts[s]);
+    for (size_t head = order.size()-1; head < order.size(); head++)
+    {
+      size_t              row = order[head];
+      std::vector<size_t> neighbors;
+      for (size_t i = first[row]; i < first[row+1]; i++)
+      {
+        if (!visited[adjacency[i]])
+        {
+          visited[adjacency[i]] = true;
+          neighbors.push_back((size_t)adjacency[i]);
+        }
+      }
+      std::stable_sort(neighbors.begin(), neighbors.end(), by_degree);
+      order.insert(order.end(), neighbors.begin(), neighbors.end());
+    }
+  }
+  std::reverse(order.begin(), order.end());
+}
+
 /**
  * \brief    Load the sample from file
  * \details  --
@@ -425,6 +1034,24 @@ void Graph::load_sample( void )
   file.close();
 }
 
+/**
+ * \brief    Build the spatial index of the nodes
+ * \details  Nodes are indexed in the nodes map order, so that distance ties are broken as in a linear scan
+ *           of the map, whatever the node order
+ * \param    void
+ * \return   \e void
+ */
+void Graph::build_spatial_index( void )
+{
+  std::vector<Node*> nodes;
+  nodes.reserve(_map.size());
+  for (std::unordered_map<int, Node*>::iterator it = _map.begin(); it != _map.end(); ++it)
+  {
+    nodes.push_back(it->second);
+  }
+  _spatial_index = new SpatialIndex(nodes);
+}
+
 /**
  * \brief    Compute the statistics
  * \details  --
@@ -586,6 +1213,82 @@ void Graph::set_introduction_node( void )
   _map[_introduction_node]->set_as_introduction_node();
 }
 
+/**
+ * \brief    Check if road weights changed since edge weights were computed
+ * \details  --
+ * \param    void
+ * \return   \e bool
+ */
+bool Graph::road_weights_changed( void ) const
+{
+  return (_road_weights[0] != _parameters->get_w1() ||
+          _road_weights[1] != _parameters->get_w2() ||
+          _road_weights[2] != _parameters->get_w3() ||
+          _road_weights[3] != _parameters->get_w4() ||
+          _road_weights[4] != _parameters->get_w5() ||
+          _road_weights[5] != _parameters->get_w6() ||
+          _road_weights[6] != _parameters->get_wmin());
+}
+
+/**
+ * \brief    Save the road weights used to compute edge weights
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void Graph::save_road_weights( void )
+{
+  _road_weights[0] = _parameters->get_w1();
+  _road_weights[1] = _parameters->get_w2();
+  _road_weights[2] = _parameters->get_w3();
+  _road_weights[3] = _parameters->get_w4();
+  _road_weights[4] = _parameters->get_w5();
+  _road_weights[5] = _parameters->get_w6();
+  _road_weights[6] = _parameters->get_wmin();
+}
+
+/**
+ * \brief    Compute the simulated euclidean distance histograms of a subset of repetitions
+ * \details  Repetitions first_rep, first_rep+step, ... are computed. Each repetition owns its
+ *           nb_bins counts, so threads never write the same cells.
+ * \param    const std::vector<Node*>& nodes
+ * \param    double bin_width
+ * \param    int nb_bins
+ * \param    int first_rep
+ * \param    int step
+ * \param    std::vector<double>& counts
+ * \return   \e void
+ */
+void Graph::compute_simulated_euclidean_histograms( const std::vector<Node*>& nodes, double bin_width, int nb_bins, int first_rep, int step, std::vector<double>& counts )
+{
+  std::vector<double> x;
+  std::vector<double> y;
+  for (int rep = first_rep; rep < _parameters->get_repetitions(); rep += step)
+  {
+    MORIS_TRACE_BEGIN("rep_histogram");
+    x.clear();
+    y.clear();
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+      if (nodes[i]->isOccupied(rep))
+      {
+        x.push_back(nodes[i]->get_x());
+        y.push_back(nodes[i]->get_y());
+      }
+    }
+    double* rep_counts = &counts[(size_t)rep*nb_bins];
+    for (size_t i = 0; i < x.size(); i++)
+    {
+      for (size_t j = i+1; j < x.size(); j++)
+      {
+        double dist = sqrt((x[j]-x[i])*(x[j]-x[i]) + (y[j]-y[i])*(y[j]-y[i]));
+        rep_counts[get_distance_bin(dist, bin_width, nb_bins)] += 1.0;
+      }
+    }
+    MORIS_TRACE_END("rep_histogram", "rep", rep+1, "invaded_nodes", (int64_t)x.size());
+  }
+}
+
 /**
  * \brief    Compute the euclidean distance between two nodes
  * \details  --
@@ -602,3 +1305,141 @@ double Graph::compute_euclidean_distance( Node* node1, Node* node2 )
   return sqrt((x2-x1)*(x2-x1) + (y2-y1)*(y2-y1));
 }
 
+/**
+ * \brief    Compute the contribution of a node to the optimization score
+ * \details  Same terms as compute_score(): the squared difference between the observed and the mean simulated
+ *           number of introductions for presence-only data, the node score for presence-absence data. Nodes
+ *           without observation do not contribute.
+ * \param    Node* node
+ * \return   \e double
+ */
+double Graph::compute_node_score( Node* node ) const
+{
+  if (_parameters->get_typeofdata() == PRESENCE_ONLY && node->get_y_obs() > 0.0)
+  {
+    double difference = node->get_y_obs()-node->get_mean_nb_introductions();
+    return difference*difference;
+  }
+  else if (_parameters->get_typeofdata() == PRESENCE_ABSENCE && node->get_n_obs() > 0.0)
+  {
+    return node->get_score();
+  }
+  return 0.0;
+}
+
+/**
+ * \brief    Initialize the invasion time series
+ * \details  Records the initial state (iteration 0) if outputs are saved, and frees the series otherwise
+ * \param    void
+ * \return   \e void
+ */
+void Graph::initialize_time_series( void )
+{
+  if (!_parameters->saveOutputs())
+  {
+    std::vector<double>().swap(_time_series);
+    std::vector<double>().swap(_time_series_row);
+    std::vector<double>().swap(_time_series_intros);
+    return;
+  }
+  int nb_reps = _parameters->get_repetitions();
+  _time_series.clear();
+  _time_series_row.assign(4*nb_reps, 0.0);
+  _time_series_intros.assign(nb_reps, 0.0);
+  Node* origin = _map[_introduction_node];
+  Node* node   = get_first();
+  while (node != NULL)
+  {
+    if (_parameters->get_state_layout() == COMPACT_LAYOUT)
+    {
+      add_to_time_series<COMPACT_LAYOUT>(origin, node);
+    }
+    else
+    {
+      add_to_time_series<STANDARD_LAYOUT>(origin, node);
+    }
+    node = get_next();
+  }
+  record_time_series();
+}
+
+/**
+ * \brief    Update all the node states, in a given state layout
+ * \details  When outputs are saved, the invasion time series is accumulated in the same pass
+ * \param    void
+ * \return   \e void
+ */
+template <state_layout LAYOUT>
+void Graph::update_node_states( void )
+{
+  if (!_parameters->saveOutputs())
+  {
+    Node* node = get_first();
+    while (node != NULL)
+    {
+      node->update_state<LAYOUT>();
+      node = get_next();
+    }
+    return;
+  }
+  _time_series_row.assign(_time_series_row.size(), 0.0);
+  Node* origin = _map[_introduction_node];
+  Node* node   = get_first();
+  while (node != NULL)
+  {
+    node->update_state<LAYOUT>();
+    add_to_time_series<LAYOUT>(origin, node);
+    node = get_next();
+  }
+  record_time_series();
+}
+
+/**
+ * \brief    Add a node to the time series rows of the current iteration
+ * \details  Rows hold the number of invaded nodes, the total number of introductions, and the maximum and
+ *           sum of the euclidean distances of invaded nodes from the origin
+ * \param    Node* origin
+ * \param    Node* node
+ * \return   \e void
+ */
+template <state_layout LAYOUT>
+void Graph::add_to_time_series( Node* origin, Node* node )
+{
+  double  distance = -1.0;
+  double* row      = _time_series_row.data();
+  for (int rep = 0; rep < _parameters->get_repetitions(); rep++)
+  {
+    row[1] += node->get_nb_introductions<LAYOUT>(rep);
+    if (node->isOccupied<LAYOUT>(rep))
+    {
+      if (distance < 0.0)
+      {
+        distance = compute_euclidean_distance(origin, node);
+      }
+      row[0] += 1.0;
+      row[2]  = (distance > row[2] ? distance : row[2]);
+      row[3] += distance;
+    }
+    row += 4;
+  }
+}
+
+/**
+ * \brief    Record the time series rows of the current iteration
+ * \details  Totals of introductions are turned into new introductions, and sums of distances into means
+ * \param    void
+ * \return   \e void
+ */
+void Graph::record_time_series( void )
+{
+  double* row = _time_series_row.data();
+  for (int rep = 0; rep < _parameters->get_repetitions(); rep++)
+  {
+    double total             = row[1];
+    row[1]                   = total-_time_series_intros[rep];
+    row[3]                   = (row[0] > 0.0 ? row[3]/row[0] : 0.0);
+    _time_series_intros[rep] = total;
+    row                     += 4;
+  }
+  _time_series.insert(_time_series.end(), _time_series_row.begin(), _time_series_row.end());
+}
@@ -34,6 +34,11 @@
 #include <sstream>
 #include <cmath>
 #include <unordered_map>
+#include <vector>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <stdlib.h>
 #include <assert.h>
@@ -42,6 +47,8 @@
 #include "Prng.h"
 #include "Parameters.h"
 #include "Node.h"
+#include "SpatialIndex.h"
+#include "TextWriter.h"
 
 
 class Graph
@@ -68,9 +75,13 @@ public:
   /*--------------------------------------- GRAPH STRUCTURE */
   
   inline int   get_number_of_nodes( void );
+  inline int   get_number_of_edges( void ) const;
   inline Node* get_node( int identifier );
   inline Node* get_first( void );
   inline Node* get_next( void );
+  inline Node* get_nearest_node( double x, double y ) const;
+  inline void  get_nodes_in_radius( double x, double y, double radius, std::vector<Node*>& nodes ) const;
+  inline void  get_nodes_in_box( double xmin, double xmax, double ymin, double ymax, std::vector<Node*>& nodes ) const;
   
   /*--------------------------------------- MINIMIZATION SCORES */
   
@@ -88,15 +99,26 @@ public:
   /*----------------------------
    * PUBLIC METHODS
    *----------------------------*/
+  void reinitialize( void );
   void untag( void );
   void update_state( void );
   void compute_score( bool empty );
   void write_state( std::string filename );
-  void write_invasion_euclidean_distributions( std::string observed_filename, std::string simulated_filename );
+  void capture_state( std::vector<int>& identifiers, std::vector<double>& values );
+  void write_invasion_euclidean_distributions( std::string observed_filename, std::string simulated_filename, int nb_bins );
+  void write_invasion_time_series( std::string filename );
+  void write_checkpoint( std::ofstream& file );
+  void read_checkpoint( std::ifstream& file );
+  
+  static void   write_captured_state( std::string filename, const std::vector<int>& identifiers, const std::vector<double>& values );
+  static int    get_state_value_index( std::string name );
+  static double estimate_memory( Parameters* parameters, state_layout layout, int nb_nodes, int nb_edges );
   
   /*----------------------------
    * PUBLIC ATTRIBUTES
    *----------------------------*/
+  static const int         STATE_VALUES = 27;         /*!< Number of values by node in a state (besides the identifier) */
+  static const char* const STATE_NAMES[STATE_VALUES]; /*!< Names of the state values                                     */
   
 protected:
   
@@ -106,12 +128,28 @@ protected:
   int    get_introduction_node_from_coordinates( void );
   void   load_map( void );
   void   load_network( void );
+  void   load_ordered_graph( void );
+  void   choose_state_layout( void );
+  void   allocate_states( void );
+  void   compute_hilbert_order( const std::vector<double>& map_data, std::vector<size_t>& order );
+  void   compute_rcm_order( const std::vector<int>& identifiers, const std::vector<int>& edges, std::vector<size_t>& order );
   void   load_sample( void );
+  void   build_spatial_index( void );
   void   compute_statistics( void );
   void   compute_human_activity_index( void );
   void   reset_states( void );
   void   set_introduction_node( void );
+  bool   road_weights_changed( void ) const;
+  void   save_road_weights( void );
+  void   initialize_time_series( void );
+  template <state_layout LAYOUT> void update_node_states( void );
+  template <state_layout LAYOUT> void add_to_time_series( Node* origin, Node* node );
+  void   record_time_series( void );
+  void   compute_simulated_euclidean_histograms( const std::vector<Node*>& nodes, double bin_width, int nb_bins, int first_rep, int step, std::vector<double>& counts );
   double compute_euclidean_distance( Node* node1, Node* node2 );
+  double compute_node_score( Node* node ) const;
+  
+  inline int get_distance_bin( double distance, double bin_width, int nb_bins ) const;
   
   /*----------------------------
    * PROTECTED ATTRIBUTES
@@ -123,8 +161,11 @@ protected:
   
   /*--------------------------------------- GRAPH STRUCTURE */
   
-  std::unordered_map<int, Node*>           _map; /*!< Nodes map          */
-  std::unordered_map<int, Node*>::iterator _it;  /*!< Nodes map iterator */
+  std::unordered_map<int, Node*> _map;           /*!< Nodes map                                 */
+  std::vector<Node*>             _nodes;         /*!< Nodes in the order of the simulation loop */
+  size_t                         _next_node;     /*!< Nodes iterator                            */
+  int                            _nb_edges;      /*!< Number of edges (lines of the network)    */
+  SpatialIndex*                  _spatial_index; /*!< Spatial index of the nodes                */
   
   /*--------------------------------------- GRAPH STATISTICS */
   
@@ -148,6 +189,13 @@ protected:
   double _mean_road_density;       /*!< Mean population size         */
   double _max_road_density;        /*!< Maximum population size      */
   
+  /*--------------------------------------- DERIVED DATA INPUTS */
+  
+  double _road_weights[7];      /*!< Road weights (w1-w6, wmin) used for edge weights      */
+  double _x_introduction;       /*!< X coordinate used to find the introduction node       */
+  double _y_introduction;       /*!< Y coordinate used to find the introduction node       */
+  bool   _human_activity_index; /*!< Human activity index usage of the current node values */
+  
   /*--------------------------------------- MINIMIZATION SCORE */
   
   double _total_log_likelihood;         /*!< Total log hypergeometric likelihood         */
@@ -156,6 +204,12 @@ protected:
   double _empty_score;                  /*!< Optimization score with empty map           */
   double _score;                        /*!< Optimization score                          */
   
+  /*--------------------------------------- INVASION TIME SERIES */
+  
+  std::vector<double> _time_series;        /*!< Rows by iteration and repetition              */
+  std::vector<double> _time_series_row;    /*!< Rows of the current iteration                 */
+  std::vector<double> _time_series_intros; /*!< Total number of introductions at the last row */
+  
 };
 
 
@@ -176,6 +230,17 @@ inline int Graph::get_number_of_nodes( void )
   return (int)_map.size();
 }
 
+/**
+ * \brief    Get total number of edges
+ * \details  One edge by line of the network file
+ * \param    void
+ * \return   \e int
+ */
+inline int Graph::get_number_of_edges( void ) const
+{
+  return _nb_edges;
+}
+
 /**
  * \brief    Get node
  * \details  --
@@ -193,14 +258,14 @@ inline Node* Graph::get_node( int identifier )
 
 /**
  * \brief    Get first node
- * \details  --
+ * \details  Nodes are visited in the order of the simulation loop (see node_order)
  * \param    void
  * \return   \e Node*
  */
 inline Node* Graph::get_first( void )
 {
-  _it = _map.begin();
-  return _it->second;
+  _next_node = 0;
+  return get_next();
 }
 
 /**
@@ -211,12 +276,53 @@ inline Node* Graph::get_first( void )
  */
 inline Node* Graph::get_next( void )
 {
-  ++_it;
-  if (_it == _map.end())
+  if (_next_node == _nodes.size())
   {
     return NULL;
   }
-  return _it->second;
+  return _nodes[_next_node++];
+}
+
+/**
+ * \brief    Get the nearest node from a point
+ * \details  --
+ * \param    double x
+ * \param    double y
+ * \return   \e Node*
+ */
+inline Node* Graph::get_nearest_node( double x, double y ) const
+{
+  double distance = 0.0;
+  return _spatial_index->get_nearest(x, y, distance);
+}
+
+/**
+ * \brief    Get the nodes at a distance lower or equal to radius from a point
+ * \details  --
+ * \param    double x
+ * \param    double y
+ * \param    double radius
+ * \param    std::vector<Node*>& nodes
+ * \return   \e void
+ */
+inline void Graph::get_nodes_in_radius( double x, double y, double radius, std::vector<Node*>& nodes ) const
+{
+  _spatial_index->get_in_radius(x, y, radius, nodes);
+}
+
+/**
+ * \brief    Get the nodes inside a rectangular box
+ * \details  --
+ * \param    double xmin
+ * \param    double xmax
+ * \param    double ymin
+ * \param    double ymax
+ * \param    std::vector<Node*>& nodes
+ * \return   \e void
+ */
+inline void Graph::get_nodes_in_box( double xmin, double xmax, double ymin, double ymax, std::vector<Node*>& nodes ) const
+{
+  _spatial_index->get_in_box(xmin, xmax, ymin, ymax, nodes);
 }
 
 /*--------------------------------------- MINIMIZATION SCORES */
@@ -280,5 +386,23 @@ inline double Graph::get_score( void ) const
  * SETTERS
  *----------------------------*/
 
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Get the histogram bin of a distance
+ * \details  Distances beyond the last bin are counted in the last bin
+ * \param    double distance
+ * \param    double bin_width
+ * \param    int nb_bins
+ * \return   \e int
+ */
+inline int Graph::get_distance_bin( double distance, double bin_width, int nb_bins ) const
+{
+  int bin = (int)(distance/bin_width);
+  return (bin < nb_bins ? bin : nb_bins-1);
+}
+
 
 #endif /* defined(__MoRIS__Graph__) */
@@ -0,0 +1,339 @@
+/**
+ * \file      Instrumentation.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     Instrumentation class definition
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "Instrumentation.h"
+
+#ifdef MORIS_INSTRUMENTATION
+
+#if defined(MORIS_PERF_COUNTERS) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+thread_local Instrumentation Instrumentation::_thread;
+uint64_t                     Instrumentation::_total_counts[NB_COUNTERS] = {};
+double                       Instrumentation::_total_seconds[NB_TIMERS]  = {};
+uint64_t                     Instrumentation::_total_calls[NB_TIMERS]    = {};
+std::mutex                   Instrumentation::_mutex;
+uint64_t                     Instrumentation::_total_events[NB_TIMERS][NB_HARDWARE_EVENTS] = {};
+int                          Instrumentation::_event_threads[NB_HARDWARE_EVENTS]           = {};
+int                          Instrumentation::_event_errors[NB_HARDWARE_EVENTS]            = {};
+
+
+/*----------------------------
+ * CONSTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Constructor
+ * \details  Records of a thread, created at its first instrumented event. The first records created register
+ *           the JSON report to be written at exit (see write_report()).
+ * \param    void
+ * \return   \e void
+ */
+Instrumentation::Instrumentation( void )
+{
+  static std::once_flag registered;
+  std::call_once(registered, []{ atexit(&Instrumentation::write_report); });
+  memset(_counts, 0, sizeof(_counts));
+  memset(_seconds, 0, sizeof(_seconds));
+  memset(_calls, 0, sizeof(_calls));
+  memset(_event_starts, 0, sizeof(_event_starts));
+  memset(_events, 0, sizeof(_events));
+  open_events();
+}
+
+/*----------------------------
+ * DESTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Destructor
+ * \details  Records of the thread are merged when the thread ends
+ * \param    void
+ * \return   \e void
+ */
+Instrumentation::~Instrumentation( void )
+{
+  merge();
+  close_events();
+}
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Read the hardware counters at the start of a timer
+ * \details  --
+ * \param    instrumentation_timer timer
+ * \return   \e void
+ */
+void Instrumentation::start_events( instrumentation_timer timer )
+{
+  for (int i = 0; i < NB_HARDWARE_EVENTS; i++)
+  {
+    _thread._event_starts[timer][i] = _thread.read_event(i);
+  }
+}
+
+/**
+ * \brief    Attribute the hardware counts since the start of a timer to this timer
+ * \details  --
+ * \param    instrumentation_timer timer
+ * \return   \e void
+ */
+void Instrumentation::stop_events( instrumentation_timer timer )
+{
+  for (int i = 0; i < NB_HARDWARE_EVENTS; i++)
+  {
+    uint64_t value = _thread.read_event(i);
+    if (value > _thread._event_starts[timer][i])
+    {
+      _thread._events[timer][i] += value-_thread._event_starts[timer][i];
+    }
+  }
+}
+
+/**
+ * \brief    Write the JSON report
+ * \details  Called at exit, once the records of all the threads are merged. The report is written in the file
+ *           given by the MORIS_INSTRUMENTATION_REPORT environment variable (default: instrumentation.json).
+ * \param    void
+ * \return   \e void
+ */
+void Instrumentation::write_report( void )
+{
+  const char* counter_names[NB_COUNTERS] = {"iterations", "jumps_drawn", "walk_steps", "trapped_steps", "walks_completed", "walks_trapped_at_start", "walks_trapped", "walks_left_map", "peak_tagged_nodes"};
+  const char* timer_names[NB_TIMERS]     = {"jump_phase", "update_state_phase", "score_phase"};
+  const char* event_names[NB_HARDWARE_EVENTS] = {"cycles", "instructions", "llc_misses", "branch_misses"};
+  const char* filename                   = getenv("MORIS_INSTRUMENTATION_REPORT");
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::ofstream file((filename != NULL ? filename : "instrumentation.json"), std::ios::out | std::ios::trunc);
+  if (!file)
+  {
+    std::cerr << "Error: unable to write the instrumentation report.\n";
+    return;
+  }
+  file.precision(9);
+  file << "{\n  \"counters\": {\n";
+  for (int i = 0; i < NB_COUNTERS; i++)
+  {
+    file << "    \"" << counter_names[i] << "\": " << _total_counts[i] << (i+1 < NB_COUNTERS ? ",\n" : "\n");
+  }
+  file << "  },\n  \"timers\": {\n";
+  for (int i = 0; i < NB_TIMERS; i++)
+  {
+    file << "    \"" << timer_names[i] << "\": {\"seconds\": " << _total_seconds[i] << ", \"calls\": " << _total_calls[i] << "}" << (i+1 < NB_TIMERS ? ",\n" : "\n");
+  }
+  double jumps = (double)_total_counts[JUMPS_DRAWN];
+  file << "  },\n  \"derived\": {\n";
+  file << "    \"steps_by_jump\": " << (jumps > 0.0 ? (double)_total_counts[WALK_STEPS]/jumps : 0.0) << ",\n";
+  file << "    \"trapped_step_fraction\": " << (_total_counts[WALK_STEPS] > 0 ? (double)_total_counts[TRAPPED_STEPS]/(double)_total_counts[WALK_STEPS] : 0.0) << ",\n";
+  file << "    \"trapped_walk_fraction\": " << (jumps > 0.0 ? (double)_total_counts[WALKS_TRAPPED]/jumps : 0.0) << ",\n";
+  file << "    \"left_map_fraction\": " << (jumps > 0.0 ? (double)_total_counts[WALKS_LEFT_MAP]/jumps : 0.0) << "\n";
+#ifdef MORIS_PERF_COUNTERS
+  file << "  },\n  \"hardware_counters\": {\n    \"available\": {";
+  for (int i = 0; i < NB_HARDWARE_EVENTS; i++)
+  {
+    file << "\"" << event_names[i] << "\": " << (_event_threads[i] > 0 ? "true" : "false") << (i+1 < NB_HARDWARE_EVENTS ? ", " : "},\n");
+  }
+  file << "    \"errors\": {";
+  for (int i = 0; i < NB_HARDWARE_EVENTS; i++)
+  {
+    file << "\"" << event_names[i] << "\": \"" << (_event_errors[i] != 0 ? strerror(_event_errors[i]) : "") << "\"" << (i+1 < NB_HARDWARE_EVENTS ? ", " : "},\n");
+  }
+  for (int t = 0; t < NB_TIMERS; t++)
+  {
+    file << "    \"" << timer_names[t] << "\": {";
+    for (int i = 0; i < NB_HARDWARE_EVENTS; i++)
+    {
+      if (_event_threads[i] > 0)
+      {
+        file << "\"" << event_names[i] << "\": " << _total_events[t][i] << ", ";
+      }
+      else
+      {
+        file << "\"" << event_names[i] << "\": null, ";
+      }
+    }
+    double cycles       = (double)_total_events[t][CPU_CYCLES];
+    double instructions = (double)_total_events[t][INSTRUCTIONS];
+    double ratios[3]    = {(cycles > 0.0 ? instructions/cycles : -1.0), (instructions > 0.0 ? (double)_total_events[t][LLC_MISSES]*1000.0/instructions : -1.0), (instructions > 0.0 ? (double)_total_events[t][BRANCH_MISSES]*1000.0/instructions : -1.0)};
+    bool   available[3] = {(_event_threads[CPU_CYCLES] > 0 && _event_threads[INSTRUCTIONS] > 0), (_event_threads[LLC_MISSES] > 0), (_event_threads[BRANCH_MISSES] > 0)};
+    const char* ratio_names[3] = {"ipc", "llc_misses_by_kilo_instruction", "branch_misses_by_kilo_instruction"};
+    for (int i = 0; i < 3; i++)
+    {
+      file << "\"" << ratio_names[i] << "\": ";
+      if (available[i] && ratios[i] >= 0.0)
+      {
+        file << ratios[i];
+      }
+      else
+      {
+        file << "null";
+      }
+      file << (i+1 < 3 ? ", " : "");
+    }
+    file << "}";
+    file << (t+1 < NB_TIMERS ? ",\n" : "\n");
+  }
+#endif
+  file << "  }\n}\n";
+  file.close();
+}
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Merge the records of the thread
+ * \details  Counters are summed, except PEAK_TAGGED_NODES which keeps the maximum
+ * \param    void
+ * \return   \e void
+ */
+void Instrumentation::merge( void )
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (int i = 0; i < NB_COUNTERS; i++)
+  {
+    if (i == PEAK_TAGGED_NODES)
+    {
+      _total_counts[i] = (_counts[i] > _total_counts[i] ? _counts[i] : _total_counts[i]);
+    }
+    else
+    {
+      _total_counts[i] += _counts[i];
+    }
+    _counts[i] = 0;
+  }
+  for (int i = 0; i < NB_TIMERS; i++)
+  {
+    _total_seconds[i] += _seconds[i];
+    _total_calls[i]   += _calls[i];
+    _seconds[i]        = 0.0;
+    _calls[i]          = 0;
+    for (int j = 0; j < NB_HARDWARE_EVENTS; j++)
+    {
+      _total_events[i][j] += _events[i][j];
+      _events[i][j]        = 0;
+    }
+  }
+}
+
+/**
+ * \brief    Open the hardware counters of the thread
+ * \details  Each counter is opened separately with perf_event_open, for the calling thread and the user space
+ *           only. A counter which cannot be opened (not built with MORIS_PERF_COUNTERS, not on Linux, not
+ *           supported by the CPU or the virtual machine, or forbidden by perf_event_paranoid) is left
+ *           unavailable (reported as null), without affecting the others.
+ * \param    void
+ * \return   \e void
+ */
+void Instrumentation::open_events( void )
+{
+  for (int i = 0; i < NB_HARDWARE_EVENTS; i++)
+  {
+    _event_fds[i] = -1;
+  }
+#if defined(MORIS_PERF_COUNTERS) && defined(__linux__)
+  const uint64_t configs[NB_HARDWARE_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+  for (int i = 0; i < NB_HARDWARE_EVENTS; i++)
+  {
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type           = PERF_TYPE_HARDWARE;
+    attributes.size           = sizeof(attributes);
+    attributes.config         = configs[i];
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv     = 1;
+    attributes.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    _event_fds[i] = (int)syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_event_fds[i] >= 0)
+    {
+      _event_threads[i]++;
+    }
+    else
+    {
+      _event_errors[i] = errno;
+    }
+  }
+#endif
+}
+
+/**
+ * \brief    Close the hardware counters of the thread
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void Instrumentation::close_events( void )
+{
+  for (int i = 0; i < NB_HARDWARE_EVENTS; i++)
+  {
+#if defined(MORIS_PERF_COUNTERS) && defined(__linux__)
+    if (_event_fds[i] >= 0)
+    {
+      close(_event_fds[i]);
+    }
+#endif
+    _event_fds[i] = -1;
+  }
+}
+
+/**
+ * \brief    Read a hardware counter of the thread
+ * \details  The count is scaled by the fraction of time the counter was running, when the kernel multiplexes
+ *           more counters than the CPU has. Unavailable counters read 0.
+ * \param    int event
+ * \return   \e uint64_t
+ */
+uint64_t Instrumentation::read_event( int event )
+{
+#if defined(MORIS_PERF_COUNTERS) && defined(__linux__)
+  uint64_t values[3];
+  if (_event_fds[event] >= 0 && read(_event_fds[event], values, sizeof(values)) == (ssize_t)sizeof(values))
+  {
+    if (values[2] > 0 && values[2] < values[1])
+    {
+      return (uint64_t)((double)values[0]*(double)values[1]/(double)values[2]);
+    }
+    return values[0];
+  }
+#else
+  (void)event;
+#endif
+  return 0;
+}
+
+#endif /* defined(MORIS_INSTRUMENTATION) */
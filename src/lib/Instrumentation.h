@@ -0,0 +1,192 @@
+/**
+ * \file      Instrumentation.h
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     Instrumentation class declaration
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef __MoRIS__Instrumentation__
+#define __MoRIS__Instrumentation__
+
+#include "Enums.h"
+
+#ifdef MORIS_INSTRUMENTATION
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <cstdint>
+#include <cstring>
+#include <stdlib.h>
+#include <assert.h>
+
+
+class Instrumentation
+{
+  
+public:
+  
+  /*----------------------------
+   * CONSTRUCTORS
+   *----------------------------*/
+  Instrumentation( void );
+  Instrumentation( const Instrumentation& instrumentation ) = delete;
+  
+  /*----------------------------
+   * DESTRUCTORS
+   *----------------------------*/
+  ~Instrumentation( void );
+  
+  /*----------------------------
+   * GETTERS
+   *----------------------------*/
+  
+  /*----------------------------
+   * SETTERS
+   *----------------------------*/
+  Instrumentation& operator=(const Instrumentation&) = delete;
+  
+  /*----------------------------
+   * PUBLIC METHODS
+   *----------------------------*/
+  static inline void count( instrumentation_counter counter, uint64_t value );
+  static inline void maximum( instrumentation_counter counter, uint64_t value );
+  static inline void add_time( instrumentation_timer timer, std::chrono::steady_clock::time_point start );
+  static void        start_events( instrumentation_timer timer );
+  static void        stop_events( instrumentation_timer timer );
+  static void        write_report( void );
+  
+  /*----------------------------
+   * PUBLIC ATTRIBUTES
+   *----------------------------*/
+  
+protected:
+  
+  /*----------------------------
+   * PROTECTED METHODS
+   *----------------------------*/
+  void     merge( void );
+  void     open_events( void );
+  void     close_events( void );
+  uint64_t read_event( int event );
+  
+  /*----------------------------
+   * PROTECTED ATTRIBUTES
+   *----------------------------*/
+  
+  /*--------------------------------------- THREAD RECORDS */
+  
+  uint64_t _counts[NB_COUNTERS]; /*!< Counters of the thread       */
+  double   _seconds[NB_TIMERS];  /*!< Timed seconds of the thread  */
+  uint64_t _calls[NB_TIMERS];    /*!< Timed calls of the thread    */
+  
+  int      _event_fds[NB_HARDWARE_EVENTS];               /*!< Hardware counters of the thread (-1 if unavailable) */
+  uint64_t _event_starts[NB_TIMERS][NB_HARDWARE_EVENTS]; /*!< Hardware counts at the start of each timer         */
+  uint64_t _events[NB_TIMERS][NB_HARDWARE_EVENTS];       /*!< Hardware counts attributed to each timer           */
+  
+  static thread_local Instrumentation _thread; /*!< Records of the current thread */
+  
+  /*--------------------------------------- MERGED RECORDS */
+  
+  static uint64_t   _total_counts[NB_COUNTERS]; /*!< Merged counters          */
+  static double     _total_seconds[NB_TIMERS];  /*!< Merged timed seconds     */
+  static uint64_t   _total_calls[NB_TIMERS];    /*!< Merged timed calls       */
+  static std::mutex _mutex;                     /*!< Protects merged records  */
+  
+  static uint64_t _total_events[NB_TIMERS][NB_HARDWARE_EVENTS]; /*!< Merged hardware counts                         */
+  static int      _event_threads[NB_HARDWARE_EVENTS];           /*!< Threads where the hardware counter was opened  */
+  static int      _event_errors[NB_HARDWARE_EVENTS];            /*!< Last error when opening the hardware counter   */
+  
+};
+
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Add a value to a counter
+ * \details  --
+ * \param    instrumentation_counter counter
+ * \param    uint64_t value
+ * \return   \e void
+ */
+inline void Instrumentation::count( instrumentation_counter counter, uint64_t value )
+{
+  _thread._counts[counter] += value;
+}
+
+/**
+ * \brief    Keep the maximum of a counter and a value
+ * \details  --
+ * \param    instrumentation_counter counter
+ * \param    uint64_t value
+ * \return   \e void
+ */
+inline void Instrumentation::maximum( instrumentation_counter counter, uint64_t value )
+{
+  if (value > _thread._counts[counter])
+  {
+    _thread._counts[counter] = value;
+  }
+}
+
+/**
+ * \brief    Add the time elapsed since start to a timer
+ * \details  Also stops the hardware counters of the timer when built with MORIS_PERF_COUNTERS
+ * \param    instrumentation_timer timer
+ * \param    std::chrono::steady_clock::time_point start
+ * \return   \e void
+ */
+inline void Instrumentation::add_time( instrumentation_timer timer, std::chrono::steady_clock::time_point start )
+{
+  _thread._seconds[timer] += std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+  _thread._calls[timer]   += 1;
+#ifdef MORIS_PERF_COUNTERS
+  stop_events(timer);
+#endif
+}
+
+
+#define MORIS_COUNT(counter, value)   Instrumentation::count(counter, (uint64_t)(value))
+#define MORIS_MAXIMUM(counter, value) Instrumentation::maximum(counter, (uint64_t)(value))
+#ifdef MORIS_PERF_COUNTERS
+#define MORIS_TIMER_START(timer)      Instrumentation::start_events(timer); std::chrono::steady_clock::time_point moris_timer_##timer = std::chrono::steady_clock::now()
+#else
+#define MORIS_TIMER_START(timer)      std::chrono::steady_clock::time_point moris_timer_##timer = std::chrono::steady_clock::now()
+#endif
+#define MORIS_TIMER_STOP(timer)       Instrumentation::add_time(timer, moris_timer_##timer)
+
+#else
+
+#define MORIS_COUNT(counter, value)
+#define MORIS_MAXIMUM(counter, value)
+#define MORIS_TIMER_START(timer)
+#define MORIS_TIMER_STOP(timer)
+
+#endif /* defined(MORIS_INSTRUMENTATION) */
+
+#endif /* defined(__MoRIS__Instrumentation__) */
@@ -0,0 +1,375 @@
+/**
+ * \file      Landscape.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     Landscape class definition
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "Landscape.h"
+
+
+/*----------------------------
+ * CONSTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Constructor
+ * \details  Defines a synthetic lattice of width x height cells, without urban hotspot. Nothing is drawn
+ *           before the files are written: write_map(), write_network() and write_sample() must be called in
+ *           this order to obtain the same landscape from the same seed.
+ * \param    lattice_type lattice
+ * \param    int width
+ * \param    int height
+ * \param    double cell_size
+ * \param    Prng* prng
+ * \return   \e void
+ */
+Landscape::Landscape( lattice_type lattice, int width, int height, double cell_size, Prng* prng )
+{
+  assert(width > 0);
+  assert(height > 0);
+  assert(cell_size > 0.0);
+  assert(prng != NULL);
+  
+  /*--------------------------------------- LATTICE */
+  
+  _lattice   = lattice;
+  _width     = width;
+  _height    = height;
+  _cell_size = cell_size;
+  _prng      = prng;
+  
+  /*--------------------------------------- ROADS AND POPULATION */
+  
+  _road_densities[0] = 0.02;
+  _road_densities[1] = 0.05;
+  _road_densities[2] = 0.50;
+  _road_densities[3] = 0.50;
+  _road_densities[4] = 0.30;
+  _road_densities[5] = 0.20;
+  _hotspot_x.clear();
+  _hotspot_y.clear();
+  _hotspot_radius    = 0.0;
+  _hotspot_intensity = 0.0;
+  _population.clear();
+  
+  /*--------------------------------------- SAMPLE */
+  
+  _sampling_fraction = 0.1;
+  _mean_observations = 3.0;
+  _invasion_radius   = 10.0*_cell_size;
+}
+
+/*----------------------------
+ * DESTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Destructor
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+Landscape::~Landscape( void )
+{
+  _hotspot_x.clear();
+  _hotspot_y.clear();
+  _population.clear();
+  _prng = NULL;
+}
+
+/*----------------------------
+ * SETTERS
+ *----------------------------*/
+
+/**
+ * \brief    Set the mean number of roads of each category by edge
+ * \details  Road numbers are drawn from Poisson laws, and doubled at the center of urban hotspots
+ * \param    const double* densities
+ * \return   \e void
+ */
+void Landscape::set_road_densities( const double* densities )
+{
+  for (int k = 0; k < 6; k++)
+  {
+    assert(densities[k] >= 0.0);
+    _road_densities[k] = densities[k];
+  }
+}
+
+/**
+ * \brief    Draw the urban hotspots
+ * \details  Hotspot centers are drawn uniformly on the lattice. Around each center, the population is
+ *           multiplied by 1+intensity at the center and the road densities by 2, decreasing as a gaussian of
+ *           standard deviation radius (map units).
+ * \param    int nb_hotspots
+ * \param    double radius
+ * \param    double intensity
+ * \return   \e void
+ */
+void Landscape::set_hotspots( int nb_hotspots, double radius, double intensity )
+{
+  assert(nb_hotspots >= 0);
+  assert(nb_hotspots == 0 || radius > 0.0);
+  assert(intensity >= 0.0);
+  _hotspot_x.clear();
+  _hotspot_y.clear();
+  for (int i = 0; i < nb_hotspots; i++)
+  {
+    _hotspot_x.push_back(_prng->uniform()*get_x(_width-1, 1));
+    _hotspot_y.push_back(_prng->uniform()*get_y(_height-1));
+  }
+  _hotspot_radius    = radius;
+  _hotspot_intensity = intensity;
+}
+
+/**
+ * \brief    Set the sampling design
+ * \details  Each cell is sampled with probability fraction, with 1+Poisson(mean_observations-1) observations.
+ *           Observations are presences with a probability decreasing with the distance to the center of
+ *           the lattice (gaussian of standard deviation invasion_radius, map units), or always absences if
+ *           invasion_radius is 0.
+ * \param    double fraction
+ * \param    double mean_observations
+ * \param    double invasion_radius
+ * \return   \e void
+ */
+void Landscape::set_sampling( double fraction, double mean_observations, double invasion_radius )
+{
+  assert(fraction >= 0.0 && fraction <= 1.0);
+  assert(mean_observations >= 1.0);
+  assert(invasion_radius >= 0.0);
+  _sampling_fraction = fraction;
+  _mean_observations = mean_observations;
+  _invasion_radius   = invasion_radius;
+}
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Write the map file
+ * \details  Same format as MoRIS_run -map (identifier, x, y, area, suitable area, population, population
+ *           density by km², road density). Populations are drawn from a log-normal law of median 100,
+ *           multiplied in urban hotspots. The whole cell area is suitable.
+ * \param    std::string filename
+ * \return   \e void
+ */
+void Landscape::write_map( std::string filename )
+{
+  TextWriter writer(filename);
+  if (!writer.is_open())
+  {
+    std::cout << "Error: impossible to write " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  double area = _cell_size*_cell_size*(_lattice == HEX_LATTICE ? sqrt(3.0)/2.0 : 1.0);
+  _population.assign((size_t)_width*(size_t)_height, 0.0);
+  for (int row = 0; row < _height; row++)
+  {
+    for (int column = 0; column < _width; column++)
+    {
+      int    identifier      = get_identifier(column, row);
+      double x               = get_x(column, row);
+      double y               = get_y(row);
+      double urban_intensity = compute_urban_intensity(x, y);
+      double population      = floor(_prng->lognormal(100.0, 1.0)*(1.0+_hotspot_intensity*urban_intensity));
+      double road_density    = 0.0;
+      for (int k = 0; k < 6; k++)
+      {
+        road_density += _road_densities[k]*(1.0+urban_intensity);
+      }
+      _population[identifier-1] = population;
+      writer << identifier << ' ' << x << ' ' << y << ' ' << area << ' ' << area << ' ';
+      writer << population << ' ' << population*1e+6/area << ' ' << road_density << '\n';
+    }
+  }
+  writer.close();
+}
+
+/**
+ * \brief    Write the network file
+ * \details  Same format as MoRIS_run -network. Each edge between two cells is written once, and each
+ *           missing neighbor on the lattice border gives an edge to -1 (out of the map). Road numbers are
+ *           drawn while writing.
+ * \param    std::string filename
+ * \return   \e void
+ */
+void Landscape::write_network( std::string filename )
+{
+  TextWriter writer(filename);
+  if (!writer.is_open())
+  {
+    std::cout << "Error: impossible to write " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  int neighbors[6];
+  for (int row = 0; row < _height; row++)
+  {
+    for (int column = 0; column < _width; column++)
+    {
+      int    identifier      = get_identifier(column, row);
+      double urban_intensity = compute_urban_intensity(get_x(column, row), get_y(row));
+      int    nb_neighbors    = get_neighbors(column, row, neighbors);
+      for (int i = 0; i < nb_neighbors; i++)
+      {
+        if (neighbors[i] == -1)
+        {
+          write_edge(writer, identifier, -1, urban_intensity);
+        }
+        else if (neighbors[i] > identifier)
+        {
+          int    neighbor_column = (neighbors[i]-1)%_width;
+          int    neighbor_row    = (neighbors[i]-1)/_width;
+          double neighbor_urban  = compute_urban_intensity(get_x(neighbor_column, neighbor_row), get_y(neighbor_row));
+          write_edge(writer, identifier, neighbors[i], (urban_intensity+neighbor_urban)/2.0);
+        }
+      }
+    }
+  }
+  writer.close();
+}
+
+/**
+ * \brief    Write the sample file
+ * \details  Same format as MoRIS_run -sample (identifier, number of presences, number of observations),
+ *           following the sampling design (see set_sampling()). write_map() must have been called before.
+ * \param    std::string filename
+ * \return   \e void
+ */
+void Landscape::write_sample( std::string filename )
+{
+  assert(_population.size() == (size_t)_width*(size_t)_height);
+  TextWriter writer(filename);
+  if (!writer.is_open())
+  {
+    std::cout << "Error: impossible to write " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  double x_center = get_x_center();
+  double y_center = get_y_center();
+  for (int row = 0; row < _height; row++)
+  {
+    for (int column = 0; column < _width; column++)
+    {
+      int n = 0;
+      int y = 0;
+      if (_prng->uniform() < _sampling_fraction)
+      {
+        n = 1+_prng->poisson(_mean_observations-1.0);
+        if (_invasion_radius > 0.0)
+        {
+          double dx = get_x(column, row)-x_center;
+          double dy = get_y(row)-y_center;
+          y         = _prng->binomial(n, exp(-(dx*dx+dy*dy)/(2.0*_invasion_radius*_invasion_radius)));
+        }
+      }
+      writer << get_identifier(column, row) << ' ' << y << ' ' << n << '\n';
+    }
+  }
+  writer.close();
+}
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Get the neighbors of a cell
+ * \details  Neighbors out of the lattice are -1. Square lattices give the east, north, west and south
+ *           neighbors; hexagonal lattices (odd rows shifted to the east) give the six neighbors.
+ * \param    int column
+ * \param    int row
+ * \param    int* neighbors
+ * \return   \e int
+ */
+int Landscape::get_neighbors( int column, int row, int* neighbors ) const
+{
+  int dc[6];
+  int dr[6];
+  int nb_neighbors = 0;
+  if (_lattice == SQUARE_LATTICE)
+  {
+    int square_dc[4] = {1, 0, -1, 0};
+    int square_dr[4] = {0, 1, 0, -1};
+    nb_neighbors     = 4;
+    memcpy(dc, square_dc, sizeof(square_dc));
+    memcpy(dr, square_dr, sizeof(square_dr));
+  }
+  else
+  {
+    int shift      = row%2;
+    int hex_dc[6]  = {1, shift, shift-1, -1, shift-1, shift};
+    int hex_dr[6]  = {0, 1, 1, 0, -1, -1};
+    nb_neighbors   = 6;
+    memcpy(dc, hex_dc, sizeof(hex_dc));
+    memcpy(dr, hex_dr, sizeof(hex_dr));
+  }
+  for (int i = 0; i < nb_neighbors; i++)
+  {
+    int c = column+dc[i];
+    int r = row+dr[i];
+    neighbors[i] = (c >= 0 && c < _width && r >= 0 && r < _height ? get_identifier(c, r) : -1);
+  }
+  return nb_neighbors;
+}
+
+/**
+ * \brief    Compute the urban intensity at a location
+ * \details  Sum of the gaussian kernels of the hotspots (about 1 at a hotspot center, 0 without hotspot)
+ * \param    double x
+ * \param    double y
+ * \return   \e double
+ */
+double Landscape::compute_urban_intensity( double x, double y ) const
+{
+  double intensity = 0.0;
+  for (size_t i = 0; i < _hotspot_x.size(); i++)
+  {
+    double dx  = x-_hotspot_x[i];
+    double dy  = y-_hotspot_y[i];
+    intensity += exp(-(dx*dx+dy*dy)/(2.0*_hotspot_radius*_hotspot_radius));
+  }
+  return intensity;
+}
+
+/**
+ * \brief    Write an edge of the network, drawing its roads
+ * \details  --
+ * \param    TextWriter& writer
+ * \param    int identifier1
+ * \param    int identifier2
+ * \param    double urban_intensity
+ * \return   \e void
+ */
+void Landscape::write_edge( TextWriter& writer, int identifier1, int identifier2, double urban_intensity )
+{
+  writer << identifier1 << ' ' << identifier2;
+  for (int k = 0; k < 6; k++)
+  {
+    writer << ' ' << _prng->poisson(_road_densities[k]*(1.0+urban_intensity));
+  }
+  writer << '\n';
+}
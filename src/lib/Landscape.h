@@ -0,0 +1,268 @@
+/**
+ * \file      Landscape.h
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     Landscape class declaration
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef __MoRIS__Landscape__
+#define __MoRIS__Landscape__
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "Enums.h"
+#include "Prng.h"
+#include "TextWriter.h"
+
+
+class Landscape
+{
+  
+public:
+  
+  /*----------------------------
+   * CONSTRUCTORS
+   *----------------------------*/
+  Landscape( void ) = delete;
+  Landscape( lattice_type lattice, int width, int height, double cell_size, Prng* prng );
+  Landscape( const Landscape& landscape ) = delete;
+  
+  /*----------------------------
+   * DESTRUCTORS
+   *----------------------------*/
+  ~Landscape( void );
+  
+  /*----------------------------
+   * GETTERS
+   *----------------------------*/
+  inline lattice_type get_lattice( void ) const;
+  inline int          get_width( void ) const;
+  inline int          get_height( void ) const;
+  inline int          get_number_of_cells( void ) const;
+  inline double       get_cell_size( void ) const;
+  inline double       get_x_center( void ) const;
+  inline double       get_y_center( void ) const;
+  
+  /*----------------------------
+   * SETTERS
+   *----------------------------*/
+  Landscape& operator=(const Landscape&) = delete;
+  
+  void set_road_densities( const double* densities );
+  void set_hotspots( int nb_hotspots, double radius, double intensity );
+  void set_sampling( double fraction, double mean_observations, double invasion_radius );
+  
+  /*----------------------------
+   * PUBLIC METHODS
+   *----------------------------*/
+  void write_map( std::string filename );
+  void write_network( std::string filename );
+  void write_sample( std::string filename );
+  
+  /*----------------------------
+   * PUBLIC ATTRIBUTES
+   *----------------------------*/
+  
+protected:
+  
+  /*----------------------------
+   * PROTECTED METHODS
+   *----------------------------*/
+  inline int    get_identifier( int column, int row ) const;
+  inline double get_x( int column, int row ) const;
+  inline double get_y( int row ) const;
+  int           get_neighbors( int column, int row, int* neighbors ) const;
+  double        compute_urban_intensity( double x, double y ) const;
+  void          write_edge( TextWriter& writer, int identifier1, int identifier2, double urban_intensity );
+  
+  /*----------------------------
+   * PROTECTED ATTRIBUTES
+   *----------------------------*/
+  
+  /*--------------------------------------- LATTICE */
+  
+  lattice_type _lattice;   /*!< Lattice type                    */
+  int          _width;     /*!< Number of columns               */
+  int          _height;    /*!< Number of rows                  */
+  double       _cell_size; /*!< Distance between cell centers   */
+  Prng*        _prng;      /*!< Pseudorandom numbers generator  */
+  
+  /*--------------------------------------- ROADS AND POPULATION */
+  
+  double              _road_densities[6]; /*!< Mean number of roads of each category by edge (outside hotspots) */
+  std::vector<double> _hotspot_x;         /*!< X coordinate of each urban hotspot                               */
+  std::vector<double> _hotspot_y;         /*!< Y coordinate of each urban hotspot                               */
+  double              _hotspot_radius;    /*!< Hotspot radius (map units, gaussian standard deviation)          */
+  double              _hotspot_intensity; /*!< Population and road density multiplier at a hotspot center       */
+  std::vector<double> _population;        /*!< Population of each cell (drawn by write_map())                   */
+  
+  /*--------------------------------------- SAMPLE */
+  
+  double _sampling_fraction; /*!< Fraction of sampled cells                                      */
+  double _mean_observations; /*!< Mean number of observations by sampled cell                    */
+  double _invasion_radius;   /*!< Radius of the synthetic invasion around the center (map units) */
+  
+};
+
+
+/*----------------------------
+ * GETTERS
+ *----------------------------*/
+
+/**
+ * \brief    Get the lattice type
+ * \details  --
+ * \param    void
+ * \return   \e lattice_type
+ */
+inline lattice_type Landscape::get_lattice( void ) const
+{
+  return _lattice;
+}
+
+/**
+ * \brief    Get the number of columns of the lattice
+ * \details  --
+ * \param    void
+ * \return   \e int
+ */
+inline int Landscape::get_width( void ) const
+{
+  return _width;
+}
+
+/**
+ * \brief    Get the number of rows of the lattice
+ * \details  --
+ * \param    void
+ * \return   \e int
+ */
+inline int Landscape::get_height( void ) const
+{
+  return _height;
+}
+
+/**
+ * \brief    Get the number of cells
+ * \details  --
+ * \param    void
+ * \return   \e int
+ */
+inline int Landscape::get_number_of_cells( void ) const
+{
+  return _width*_height;
+}
+
+/**
+ * \brief    Get the distance between cell centers
+ * \details  --
+ * \param    void
+ * \return   \e double
+ */
+inline double Landscape::get_cell_size( void ) const
+{
+  return _cell_size;
+}
+
+/**
+ * \brief    Get the x coordinate of the central cell
+ * \details  --
+ * \param    void
+ * \return   \e double
+ */
+inline double Landscape::get_x_center( void ) const
+{
+  return get_x(_width/2, _height/2);
+}
+
+/**
+ * \brief    Get the y coordinate of the central cell
+ * \details  --
+ * \param    void
+ * \return   \e double
+ */
+inline double Landscape::get_y_center( void ) const
+{
+  return get_y(_height/2);
+}
+
+/*----------------------------
+ * SETTERS
+ *----------------------------*/
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Get the identifier of a cell
+ * \details  Cells are numbered from 1, row by row from the south-west corner
+ * \param    int column
+ * \param    int row
+ * \return   \e int
+ */
+inline int Landscape::get_identifier( int column, int row ) const
+{
+  return row*_width+column+1;
+}
+
+/**
+ * \brief    Get the x coordinate of a cell center
+ * \details  Odd rows of a hexagonal lattice are shifted by half a cell to the east
+ * \param    int column
+ * \param    int row
+ * \return   \e double
+ */
+inline double Landscape::get_x( int column, int row ) const
+{
+  if (_lattice == HEX_LATTICE && row%2 == 1)
+  {
+    return (column+0.5)*_cell_size;
+  }
+  return column*_cell_size;
+}
+
+/**
+ * \brief    Get the y coordinate of a cell center
+ * \details  Rows of a hexagonal lattice are sqrt(3)/2 cell size apart
+ * \param    int row
+ * \return   \e double
+ */
+inline double Landscape::get_y( int row ) const
+{
+  if (_lattice == HEX_LATTICE)
+  {
+    return row*_cell_size*sqrt(3.0)/2.0;
+  }
+  return row*_cell_size;
+}
+
+
+#endif /* defined(__MoRIS__Landscape__) */
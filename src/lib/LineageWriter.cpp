@@ -0,0 +1,273 @@
+/**
+ * \file      LineageWriter.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     LineageWriter class definition
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "LineageWriter.h"
+
+
+/*----------------------------
+ * CONSTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Constructor
+ * \details  Creates the binary lineage file and starts the writer thread. The file starts with the header
+ *           "MoRISLIN" and the format version. Each block then gives its number of records, its raw size, its
+ *           stored size and its compression flag (1 if zlib compressed, 0 if stored as is), followed by the stored
+ *           bytes. A record holds the repetition (from 1), the start node, the end node and the iteration (int32),
+ *           then the geodesic and euclidean distances (double), in native byte order.
+ *           With append, blocks are added at the end of an existing lineage file (see Simulation::load_checkpoint()).
+ * \param    std::string filename
+ * \param    bool append
+ * \return   \e void
+ */
+LineageWriter::LineageWriter( std::string filename, bool append )
+{
+  /*--------------------------------------- OUTPUT */
+  
+  _file.open(filename, std::ios::out | (append ? std::ios::app : std::ios::trunc) | std::ios::binary);
+  if (!_file)
+  {
+    std::cout << "Error: unable to open lineage file " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  if (!append)
+  {
+    uint32_t version = (uint32_t)VERSION;
+    _file.write("MoRISLIN", 8);
+    _file.write((const char*)&version, sizeof(uint32_t));
+  }
+  _compressed.clear();
+  
+  /*--------------------------------------- DOUBLE BUFFER */
+  
+  for (int i = 0; i < 2; i++)
+  {
+    _blocks[i].assign((size_t)BLOCK_RECORDS*RECORD_SIZE, 0);
+    _sizes[i]   = 0;
+    _pending[i] = false;
+  }
+  _current    = 0;
+  _next_write = 0;
+  
+  /*--------------------------------------- WRITER THREAD */
+  
+  _stop   = false;
+  _thread = std::thread(&LineageWriter::run, this);
+}
+
+/*----------------------------
+ * DESTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Destructor
+ * \details  Remaining events are written before the file is closed
+ * \param    void
+ * \return   \e void
+ */
+LineageWriter::~LineageWriter( void )
+{
+  flush();
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _condition.notify_all();
+  _thread.join();
+  _file.close();
+  _compressed.clear();
+  _blocks[0].clear();
+  _blocks[1].clear();
+}
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Write all the events added so far
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void LineageWriter::flush( void )
+{
+  if (_sizes[_current] > 0)
+  {
+    submit_block();
+  }
+  std::unique_lock<std::mutex> lock(_mutex);
+  _condition.wait(lock, [this]{ return !_pending[0] && !_pending[1]; });
+  _file.flush();
+}
+
+/**
+ * \brief    Convert a binary lineage file to the lineage tree text format
+ * \details  The text file is identical to the lineage tree written with the EVENTS lineage mode
+ * \param    std::string binary_filename
+ * \param    std::string text_filename
+ * \return   \e void
+ */
+void LineageWriter::convert_to_text( std::string binary_filename, std::string text_filename )
+{
+  std::ifstream input(binary_filename, std::ios::in | std::ios::binary);
+  char          magic[8];
+  uint32_t      version = 0;
+  input.read(magic, 8);
+  input.read((char*)&version, sizeof(uint32_t));
+  if (!input || strncmp(magic, "MoRISLIN", 8) != 0 || version != (uint32_t)VERSION)
+  {
+    std::cout << "Error: " << binary_filename << " is not a valid lineage file.\n";
+    exit(EXIT_FAILURE);
+  }
+  TextWriter output(text_filename);
+  output << "repetition start_node end_node geodesic_dist euclidean_dist iteration\n";
+  std::vector<char> stored;
+  std::vector<char> raw;
+  uint32_t          header[4];
+  while (input.read((char*)header, sizeof(header)))
+  {
+    uint32_t nb_records = header[0];
+    uint32_t raw_size   = header[1];
+    uint32_t size       = header[2];
+    stored.resize(size);
+    if (raw_size != nb_records*(uint32_t)RECORD_SIZE || !input.read(stored.data(), size))
+    {
+      std::cout << "Error: truncated lineage file " << binary_filename << ".\n";
+      exit(EXIT_FAILURE);
+    }
+    if (header[3] == 0)
+    {
+      raw.swap(stored);
+    }
+    else
+    {
+#ifdef HAVE_ZLIB
+      raw.resize(raw_size);
+      uLongf length = raw_size;
+      if (uncompress((Bytef*)raw.data(), &length, (const Bytef*)stored.data(), size) != Z_OK || length != raw_size)
+      {
+        std::cout << "Error: corrupted lineage file " << binary_filename << ".\n";
+        exit(EXIT_FAILURE);
+      }
+#else
+      std::cout << "Error: " << binary_filename << " is compressed, but MoRIS was built without zlib.\n";
+      exit(EXIT_FAILURE);
+#endif
+    }
+    for (uint32_t i = 0; i < nb_records; i++)
+    {
+      int32_t integers[4];
+      double  reals[2];
+      memcpy(integers, &raw[(size_t)i*RECORD_SIZE], sizeof(integers));
+      memcpy(reals, &raw[(size_t)i*RECORD_SIZE+sizeof(integers)], sizeof(reals));
+      output << integers[0] << ' ' << integers[1] << ' ' << integers[2] << ' ' << reals[0] << ' ' << reals[1] << ' ' << integers[3] << '\n';
+    }
+  }
+  output.close();
+  input.close();
+}
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Hand the current block to the writer thread and switch to the other buffer
+ * \details  Waits if the other buffer is still being written
+ * \param    void
+ * \return   \e void
+ */
+void LineageWriter::submit_block( void )
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _pending[_current] = true;
+  _current           = 1-_current;
+  _condition.notify_all();
+  _condition.wait(lock, [this]{ return !_pending[_current]; });
+  _sizes[_current] = 0;
+}
+
+/**
+ * \brief    Writer thread loop
+ * \details  Compresses and writes the blocks in submission order
+ * \param    void
+ * \return   \e void
+ */
+void LineageWriter::run( void )
+{
+  while (true)
+  {
+    int buffer = 0;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this]{ return _pending[_next_write] || _stop; });
+      if (!_pending[_next_write])
+      {
+        return;
+      }
+      buffer = _next_write;
+    }
+    MORIS_TRACE_BEGIN("lineage_write");
+    write_block(buffer);
+    MORIS_TRACE_END("lineage_write", "events", (int64_t)_sizes[buffer]);
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _pending[buffer] = false;
+      _next_write      = 1-_next_write;
+    }
+    _condition.notify_all();
+  }
+}
+
+/**
+ * \brief    Compress and write a block
+ * \details  Blocks are stored as is when zlib is not available or does not reduce their size
+ * \param    int buffer
+ * \return   \e void
+ */
+void LineageWriter::write_block( int buffer )
+{
+  uint32_t    raw_size   = (uint32_t)(_sizes[buffer]*RECORD_SIZE);
+  const char* data       = _blocks[buffer].data();
+  uint32_t    size       = raw_size;
+  uint32_t    compressed = 0;
+#ifdef HAVE_ZLIB
+  uLongf length = compressBound(raw_size);
+  _compressed.resize(length);
+  if (compress2((Bytef*)_compressed.data(), &length, (const Bytef*)data, raw_size, Z_BEST_SPEED) == Z_OK && length < raw_size)
+  {
+    data       = _compressed.data();
+    size       = (uint32_t)length;
+    compressed = 1;
+  }
+#endif
+  uint32_t header[4] = {(uint32_t)_sizes[buffer], raw_size, size, compressed};
+  _file.write((const char*)header, sizeof(header));
+  _file.write(data, size);
+}
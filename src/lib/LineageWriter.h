@@ -0,0 +1,164 @@
+/**
+ * \file      LineageWriter.h
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     LineageWriter class declaration
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef __MoRIS__LineageWriter__
+#define __MoRIS__LineageWriter__
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <stdlib.h>
+#include <assert.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "TextWriter.h"
+
+
+class LineageWriter
+{
+  
+public:
+  
+  /*----------------------------
+   * CONSTRUCTORS
+   *----------------------------*/
+  LineageWriter( void ) = delete;
+  LineageWriter( std::string filename, bool append );
+  LineageWriter( const LineageWriter& writer ) = delete;
+  
+  /*----------------------------
+   * DESTRUCTORS
+   *----------------------------*/
+  ~LineageWriter( void );
+  
+  /*----------------------------
+   * GETTERS
+   *----------------------------*/
+  
+  /*----------------------------
+   * SETTERS
+   *----------------------------*/
+  LineageWriter& operator=(const LineageWriter&) = delete;
+  
+  /*----------------------------
+   * PUBLIC METHODS
+   *----------------------------*/
+  inline void add_event( int repetition, int start_node, int end_node, double geodesic_dist, double euclidean_dist, int iteration );
+  void        flush( void );
+  
+  static void convert_to_text( std::string binary_filename, std::string text_filename );
+  
+  /*----------------------------
+   * PUBLIC ATTRIBUTES
+   *----------------------------*/
+  static const int VERSION       = 1;     /*!< Binary lineage format version */
+  static const int RECORD_SIZE   = 32;    /*!< Size of an event record       */
+  static const int BLOCK_RECORDS = 65536; /*!< Number of records by block    */
+  
+protected:
+  
+  /*----------------------------
+   * PROTECTED METHODS
+   *----------------------------*/
+  void submit_block( void );
+  void run( void );
+  void write_block( int buffer );
+  
+  /*----------------------------
+   * PROTECTED ATTRIBUTES
+   *----------------------------*/
+  
+  /*--------------------------------------- OUTPUT */
+  
+  std::ofstream     _file;       /*!< Binary lineage file     */
+  std::vector<char> _compressed; /*!< Compression buffer      */
+  
+  /*--------------------------------------- DOUBLE BUFFER */
+  
+  std::vector<char> _blocks[2];  /*!< Event records of each buffer           */
+  size_t            _sizes[2];   /*!< Number of records in each buffer       */
+  bool              _pending[2]; /*!< Buffers waiting for (or being) written */
+  int               _current;    /*!< Buffer being filled                    */
+  int               _next_write; /*!< Next buffer to write                   */
+  
+  /*--------------------------------------- WRITER THREAD */
+  
+  std::thread             _thread;    /*!< Writer thread                       */
+  std::mutex              _mutex;     /*!< Protects the buffer flags           */
+  std::condition_variable _condition; /*!< Signals buffer flag changes         */
+  bool                    _stop;      /*!< Asks the writer thread to terminate */
+  
+};
+
+
+/*----------------------------
+ * GETTERS
+ *----------------------------*/
+
+/*----------------------------
+ * SETTERS
+ *----------------------------*/
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Add a lineage event
+ * \details  The record is appended to the current block, which is handed to the writer thread when full
+ * \param    int repetition
+ * \param    int start_node
+ * \param    int end_node
+ * \param    double geodesic_dist
+ * \param    double euclidean_dist
+ * \param    int iteration
+ * \return   \e void
+ */
+inline void LineageWriter::add_event( int repetition, int start_node, int end_node, double geodesic_dist, double euclidean_dist, int iteration )
+{
+  int32_t integers[4] = {(int32_t)repetition, (int32_t)start_node, (int32_t)end_node, (int32_t)iteration};
+  double  reals[2]    = {geodesic_dist, euclidean_dist};
+  char*   record      = &_blocks[_current][_sizes[_current]*RECORD_SIZE];
+  memcpy(record, integers, sizeof(integers));
+  memcpy(record+sizeof(integers), reals, sizeof(reals));
+  if (++_sizes[_current] == (size_t)BLOCK_RECORDS)
+  {
+    submit_block();
+  }
+}
+
+
+#endif /* defined(__MoRIS__LineageWriter__) */
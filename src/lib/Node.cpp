@@ -63,6 +63,7 @@ Node::Node( Parameters* parameters, int identifier )
   /*--------------------------------------- NETWORK */
   
   _neighbors.clear();
+  _roads.clear();
   _weights.clear();
   _weights_sum          = 0.0;
   _human_activity_index = 0.0;
@@ -75,29 +76,23 @@ Node::Node( Parameters* parameters, int identifier )
   
   /*--------------------------------------- SIMULATION VARIABLES */
   
-  _tagged                 = false;
-  _current_state          = new int[_parameters->get_repetitions()];
-  _next_state             = new int[_parameters->get_repetitions()];
-  _nb_introductions       = new double[_parameters->get_repetitions()];
-  _total_nb_introductions = 0.0;
-  _mean_nb_introductions  = 0.0;
-  _var_nb_introductions   = 0.0;
-  for (int i = 0; i < _parameters->get_repetitions(); i++)
-  {
-    _current_state[i]    = 0;
-    _next_state[i]       = 0;
-    _nb_introductions[i] = 0.0;
-  }
-  _n_sim              = (double)_parameters->get_repetitions();
-  _y_sim              = 0.0;
-  _p_sim              = 0.0;
-  _first_invasion_age = new double[_parameters->get_repetitions()];
-  _last_invasion_age  = new double[_parameters->get_repetitions()];
-  for (int i = 0; i < _parameters->get_repetitions(); i++)
-  {
-    _first_invasion_age[i] = -1.0;
-    _last_invasion_age[i]  = -1.0;
-  }
+  _compact                    = false;
+  _tagged                     = false;
+  _current_state              = NULL;
+  _next_state                 = NULL;
+  _nb_introductions           = NULL;
+  _first_invasion_age         = NULL;
+  _last_invasion_age          = NULL;
+  _packed_states              = NULL;
+  _compact_nb_introductions   = NULL;
+  _compact_first_invasion_age = NULL;
+  _compact_last_invasion_age  = NULL;
+  _total_nb_introductions  = 0.0;
+  _mean_nb_introductions   = 0.0;
+  _var_nb_introductions    = 0.0;
+  _n_sim                   = (double)_parameters->get_repetitions();
+  _y_sim                   = 0.0;
+  _p_sim                   = 0.0;
   _mean_first_invasion_age = 0.0;
   _mean_last_invasion_age  = 0.0;
   _var_first_invasion_age  = 0.0;
@@ -130,6 +125,7 @@ Node::~Node( void )
   /*--------------------------------------- NETWORK */
   
   _neighbors.clear();
+  _roads.clear();
   _weights.clear();
   
   /*--------------------------------------- SIMULATION VARIABLES */
@@ -144,12 +140,54 @@ Node::~Node( void )
   _first_invasion_age = NULL;
   delete[] _last_invasion_age;
   _last_invasion_age = NULL;
+  delete[] _packed_states;
+  _packed_states = NULL;
+  delete[] _compact_nb_introductions;
+  _compact_nb_introductions = NULL;
+  delete[] _compact_first_invasion_age;
+  _compact_first_invasion_age = NULL;
+  delete[] _compact_last_invasion_age;
+  _compact_last_invasion_age = NULL;
 }
 
 /*----------------------------
  * PUBLIC METHODS
  *----------------------------*/
 
+/**
+ * \brief    Allocate the node states of each repetition
+ * \details  Called once by the graph, when the state layout of the parameters is chosen (see
+ *           Graph::choose_state_layout()). States are initialized as empty.
+ * \param    void
+ * \return   \e void
+ */
+void Node::allocate_states( void )
+{
+  assert(_current_state == NULL && _packed_states == NULL);
+  assert(_parameters->get_state_layout() != AUTO_LAYOUT);
+  int nb_reps = _parameters->get_repetitions();
+  _compact    = (_parameters->get_state_layout() == COMPACT_LAYOUT);
+  if (_compact)
+  {
+    _packed_states              = new uint8_t[nb_reps];
+    _compact_nb_introductions   = new float[nb_reps];
+    _compact_first_invasion_age = new float[nb_reps];
+    _compact_last_invasion_age  = new float[nb_reps];
+  }
+  else
+  {
+    _current_state      = new int[nb_reps];
+    _next_state         = new int[nb_reps];
+    _nb_introductions   = new double[nb_reps];
+    _first_invasion_age = new double[nb_reps];
+    _last_invasion_age  = new double[nb_reps];
+  }
+  for (int rep = 0; rep < nb_reps; rep++)
+  {
+    set_repetition(rep, 0, 0, 0.0, -1.0, -1.0);
+  }
+}
+
 /**
  * \brief    Jump to the next node
  * \details  --
@@ -198,12 +236,30 @@ Node* Node::jump( void )
   exit(EXIT_FAILURE);
 }
 
+/**
+ * \brief    Compute edge weights from the current road weights
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void Node::compute_weights( void )
+{
+  _weights_sum = 0.0;
+  for (size_t i = 0; i < _neighbors.size(); i++)
+  {
+    _weights[i]   = compute_edge_weight(i);
+    _weights_sum += _weights[i];
+  }
+}
+
 /**
  * \brief    Update node state
- * \details  This method also computes the next simulated probability of presence
+ * \details  This method also computes the next simulated probability of presence. It is instantiated for
+ *           each state layout (see Graph::update_state()).
  * \param    void
  * \return   \e void
  */
+template <state_layout LAYOUT>
 void Node::update_state( void )
 {
   _mean_nb_introductions      = 0.0;
@@ -218,21 +274,32 @@ void Node::update_state( void )
   double last_invasion_count  = 0.0;
   for (int rep = 0; rep < _parameters->get_repetitions(); rep++)
   {
-    _current_state[rep]     = _next_state[rep];
-    _mean_nb_introductions += _nb_introductions[rep];
-    _var_nb_introductions  += _nb_introductions[rep]*_nb_introductions[rep];
-    _y_sim                 += (double)_current_state[rep];
-    _p_sim                 += (double)_current_state[rep];
-    if (_first_invasion_age[rep] != -1.0)
+    if (LAYOUT == COMPACT_LAYOUT)
     {
-      _mean_first_invasion_age += _first_invasion_age[rep];
-      _var_first_invasion_age  += _first_invasion_age[rep]*_first_invasion_age[rep];
+      _packed_states[rep] = (uint8_t)((_packed_states[rep]&2) != 0 ? 3 : 0);
+    }
+    else
+    {
+      _current_state[rep] = _next_state[rep];
+    }
+    double nb_introductions   = get_nb_introductions<LAYOUT>(rep);
+    double first_invasion_age = get_first_invasion_age<LAYOUT>(rep);
+    double last_invasion_age  = get_last_invasion_age<LAYOUT>(rep);
+    double state              = (isOccupied<LAYOUT>(rep) ? 1.0 : 0.0);
+    _mean_nb_introductions   += nb_introductions;
+    _var_nb_introductions    += nb_introductions*nb_introductions;
+    _y_sim                   += state;
+    _p_sim                   += state;
+    if (first_invasion_age != -1.0)
+    {
+      _mean_first_invasion_age += first_invasion_age;
+      _var_first_invasion_age  += first_invasion_age*first_invasion_age;
       first_invasion_count     += 1.0;
     }
-    if (_last_invasion_age[rep] != -1.0)
+    if (last_invasion_age != -1.0)
     {
-      _mean_last_invasion_age += _last_invasion_age[rep];
-      _var_last_invasion_age  += _last_invasion_age[rep]*_last_invasion_age[rep];
+      _mean_last_invasion_age += last_invasion_age;
+      _var_last_invasion_age  += last_invasion_age*last_invasion_age;
       last_invasion_count     += 1.0;
     }
   }
@@ -254,6 +321,9 @@ void Node::update_state( void )
   }
 }
 
+template void Node::update_state<STANDARD_LAYOUT>( void );
+template void Node::update_state<COMPACT_LAYOUT>( void );
+
 /**
  * \brief    Reset node state
  * \details  --
@@ -264,20 +334,13 @@ void Node::reset_state( void )
 {
   for (int rep = 0; rep < _parameters->get_repetitions(); rep++)
   {
-    _current_state[rep]    = 0;
-    _next_state[rep]       = 0;
-    _nb_introductions[rep] = 0.0;
+    set_repetition(rep, 0, 0, 0.0, -1.0, -1.0);
   }
   _total_nb_introductions = 0.0;
   _mean_nb_introductions  = 0.0;
   _var_nb_introductions   = 0.0;
   _y_sim                  = 0.0;
   _p_sim                  = 0.0;
-  for (int rep = 0; rep < _parameters->get_repetitions(); rep++)
-  {
-    _first_invasion_age[rep] = -1.0;
-    _last_invasion_age[rep]  = -1.0;
-  }
   _mean_first_invasion_age = 0.0;
   _mean_last_invasion_age  = 0.0;
   _var_first_invasion_age  = 0.0;
@@ -317,7 +380,146 @@ void Node::compute_score( void )
   }
 }
 
+/**
+ * \brief    Compute quantiles of the first and last invasion ages
+ * \details  Quantiles are exact and computed over the invaded repetitions only, like the mean and the variance.
+ *           Probabilities must be sorted in increasing order.
+ * \param    const double* probabilities
+ * \param    int nb_probabilities
+ * \param    double* first_quantiles
+ * \param    double* last_quantiles
+ * \param    std::vector<double>& buffer
+ * \return   \e void
+ */
+void Node::compute_invasion_age_quantiles( const double* probabilities, int nb_probabilities, double* first_quantiles, double* last_quantiles, std::vector<double>& buffer ) const
+{
+  compute_age_quantiles(true, probabilities, nb_probabilities, first_quantiles, buffer);
+  compute_age_quantiles(false, probabilities, nb_probabilities, last_quantiles, buffer);
+}
+
+/**
+ * \brief    Write the simulation variables in a binary checkpoint file
+ * \details  Writes the states, numbers of introductions and invasion ages of each repetition, then their
+ *           statistics. Scores are not saved, they are computed again at the end of the simulation. The
+ *           standard layout is always written, so that checkpoints do not depend on the state layout.
+ * \param    std::ofstream& file
+ * \return   \e void
+ */
+void Node::write_checkpoint( std::ofstream& file ) const
+{
+  int    nb_reps    = _parameters->get_repetitions();
+  double values[10] = {_total_nb_introductions, _mean_nb_introductions, _var_nb_introductions, _y_sim, _p_sim,
+                       _mean_first_invasion_age, _mean_last_invasion_age, _var_first_invasion_age, _var_last_invasion_age, _n_sim};
+  if (_compact)
+  {
+    std::vector<int>    states(2*nb_reps);
+    std::vector<double> variables(3*nb_reps);
+    for (int rep = 0; rep < nb_reps; rep++)
+    {
+      states[rep]                 = _packed_states[rep]&1;
+      states[nb_reps+rep]         = (_packed_states[rep]>>1)&1;
+      variables[rep]              = (double)_compact_nb_introductions[rep];
+      variables[nb_reps+rep]      = (double)_compact_first_invasion_age[rep];
+      variables[2*nb_reps+rep]    = (double)_compact_last_invasion_age[rep];
+    }
+    file.write((const char*)states.data(), states.size()*sizeof(int));
+    file.write((const char*)variables.data(), variables.size()*sizeof(double));
+  }
+  else
+  {
+    file.write((const char*)_current_state, nb_reps*sizeof(int));
+    file.write((const char*)_next_state, nb_reps*sizeof(int));
+    file.write((const char*)_nb_introductions, nb_reps*sizeof(double));
+    file.write((const char*)_first_invasion_age, nb_reps*sizeof(double));
+    file.write((const char*)_last_invasion_age, nb_reps*sizeof(double));
+  }
+  file.write((const char*)values, sizeof(values));
+}
+
+/**
+ * \brief    Read the simulation variables from a binary checkpoint file
+ * \details  See write_checkpoint()
+ * \param    std::ifstream& file
+ * \return   \e void
+ */
+void Node::read_checkpoint( std::ifstream& file )
+{
+  int    nb_reps    = _parameters->get_repetitions();
+  double values[10];
+  if (_compact)
+  {
+    std::vector<int>    states(2*nb_reps);
+    std::vector<double> variables(3*nb_reps);
+    file.read((char*)states.data(), states.size()*sizeof(int));
+    file.read((char*)variables.data(), variables.size()*sizeof(double));
+    for (int rep = 0; rep < nb_reps; rep++)
+    {
+      set_repetition(rep, states[rep], states[nb_reps+rep], variables[rep], variables[nb_reps+rep], variables[2*nb_reps+rep]);
+    }
+  }
+  else
+  {
+    file.read((char*)_current_state, nb_reps*sizeof(int));
+    file.read((char*)_next_state, nb_reps*sizeof(int));
+    file.read((char*)_nb_introductions, nb_reps*sizeof(double));
+    file.read((char*)_first_invasion_age, nb_reps*sizeof(double));
+    file.read((char*)_last_invasion_age, nb_reps*sizeof(double));
+  }
+  file.read((char*)values, sizeof(values));
+  _total_nb_introductions  = values[0];
+  _mean_nb_introductions   = values[1];
+  _var_nb_introductions    = values[2];
+  _y_sim                   = values[3];
+  _p_sim                   = values[4];
+  _mean_first_invasion_age = values[5];
+  _mean_last_invasion_age  = values[6];
+  _var_first_invasion_age  = values[7];
+  _var_last_invasion_age   = values[8];
+  _n_sim                   = values[9];
+  _tagged                  = false;
+}
+
 /*----------------------------
  * PROTECTED METHODS
  *----------------------------*/
 
+/**
+ * \brief    Compute quantiles of invasion ages over the invaded repetitions
+ * \details  The quantile of probability p is the lowest age reached by at least a fraction p of the invaded
+ *           repetitions (inverse of the empirical distribution function). Successive quantiles are selected
+ *           with nth_element on the remaining part of the buffer. Quantiles are 0 if no repetition was invaded.
+ * \param    bool first_invasion (first invasion ages if true, last invasion ages otherwise)
+ * \param    const double* probabilities
+ * \param    int nb_probabilities
+ * \param    double* quantiles
+ * \param    std::vector<double>& buffer
+ * \return   \e void
+ */
+void Node::compute_age_quantiles( bool first_invasion, const double* probabilities, int nb_probabilities, double* quantiles, std::vector<double>& buffer ) const
+{
+  buffer.clear();
+  for (int rep = 0; rep < _parameters->get_repetitions(); rep++)
+  {
+    double age = (first_invasion ? get_first_invasion_age(rep) : get_last_invasion_age(rep));
+    if (age != -1.0)
+    {
+      buffer.push_back(age);
+    }
+  }
+  size_t first = 0;
+  for (int i = 0; i < nb_probabilities; i++)
+  {
+    assert(probabilities[i] >= 0.0 && probabilities[i] <= 1.0);
+    assert(i == 0 || probabilities[i] >= probabilities[i-1]);
+    if (buffer.size() == 0)
+    {
+      quantiles[i] = 0.0;
+      continue;
+    }
+    size_t rank = (size_t)ceil(probabilities[i]*(double)buffer.size()-1e-9);
+    rank        = (rank < 1 ? 0 : rank-1);
+    std::nth_element(buffer.begin()+first, buffer.begin()+rank, buffer.end());
+    quantiles[i] = buffer[rank];
+    first        = rank;
+  }
+}
@@ -30,8 +30,11 @@
 #define __MoRIS__Node__
 
 #include <iostream>
+#include <fstream>
 #include <vector>
+#include <algorithm>
 #include <cstring>
+#include <cstdint>
 #include <stdlib.h>
 #include <assert.h>
 
@@ -92,6 +95,7 @@ public:
   
   inline bool   isTagged( void ) const;
   inline bool   isOccupied( int rep ) const;
+  inline double get_nb_introductions( int rep ) const;
   inline double get_total_nb_introductions( void ) const;
   inline double get_mean_nb_introductions( void ) const;
   inline double get_var_nb_introductions( void ) const;
@@ -105,6 +109,13 @@ public:
   inline double get_var_first_invasion_age( void ) const;
   inline double get_var_last_invasion_age( void ) const;
   
+  template <state_layout LAYOUT> inline bool   isOccupied( int rep ) const;
+  template <state_layout LAYOUT> inline double get_nb_introductions( int rep ) const;
+  template <state_layout LAYOUT> inline double get_first_invasion_age( int rep ) const;
+  template <state_layout LAYOUT> inline double get_last_invasion_age( int rep ) const;
+  
+  static inline size_t get_bytes_by_repetition( state_layout layout );
+  
   /*--------------------------------------- SCORES */
   
   inline double get_likelihood( void ) const;
@@ -127,7 +138,8 @@ public:
   
   /*--------------------------------------- NETWORK */
   
-  inline void add_neighbor( double weight, Node* node );
+  inline void reserve_neighbors( int nb_neighbors );
+  inline void add_neighbor( double* roads, Node* node );
   inline void set_human_activity_index( double human_activity_index );
   
   /*--------------------------------------- SAMPLE */
@@ -142,13 +154,21 @@ public:
   inline void set_as_introduction_node( void );
   inline void update_invasion_age( double age, int rep );
   
+  template <state_layout LAYOUT> inline void add_introduction( int rep );
+  template <state_layout LAYOUT> inline void update_invasion_age( double age, int rep );
+  
   /*----------------------------
    * PUBLIC METHODS
    *----------------------------*/
+  void  allocate_states( void );
   Node* jump( void );
-  void  update_state( void );
+  void  compute_weights( void );
+  template <state_layout LAYOUT> void update_state( void );
   void  reset_state( void );
   void  compute_score( void );
+  void  compute_invasion_age_quantiles( const double* probabilities, int nb_probabilities, double* first_quantiles, double* last_quantiles, std::vector<double>& buffer ) const;
+  void  write_checkpoint( std::ofstream& file ) const;
+  void  read_checkpoint( std::ifstream& file );
   
   /*----------------------------
    * PUBLIC ATTRIBUTES
@@ -159,6 +179,9 @@ protected:
   /*----------------------------
    * PROTECTED METHODS
    *----------------------------*/
+  inline double compute_edge_weight( size_t edge ) const;
+  inline void   set_repetition( int rep, int current_state, int next_state, double nb_introductions, double first_invasion_age, double last_invasion_age );
+  void          compute_age_quantiles( bool first_invasion, const double* probabilities, int nb_probabilities, double* quantiles, std::vector<double>& buffer ) const;
   
   /*----------------------------
    * PROTECTED ATTRIBUTES
@@ -172,10 +195,11 @@ protected:
   
   /*--------------------------------------- NETWORK */
   
-  std::vector<Node*>  _neighbors;            /*!< Vector of neighbors  */
-  std::vector<double> _weights;              /*!< Vector of weights    */
-  double              _weights_sum;          /*!< Sum of weights       */
-  double              _human_activity_index; /*!< Human activity index */
+  std::vector<Node*>  _neighbors;            /*!< Vector of neighbors                      */
+  std::vector<double> _roads;                /*!< Road categories lengths (6 by neighbor) */
+  std::vector<double> _weights;              /*!< Vector of weights                        */
+  double              _weights_sum;          /*!< Sum of weights                           */
+  double              _human_activity_index; /*!< Human activity index                     */
   
   /*--------------------------------------- MAP */
   
@@ -212,6 +236,14 @@ protected:
   double  _var_first_invasion_age;  /*!< Variance of age of the first invasion   */
   double  _var_last_invasion_age;   /*!< Variance of age of the last invasion    */
   
+  /*--------------------------------------- COMPACT SIMULATION VARIABLES */
+  
+  bool     _compact;                    /*!< Compact state layout (see state_layout)           */
+  uint8_t* _packed_states;              /*!< Current (bit 0) and next (bit 1) states           */
+  float*   _compact_nb_introductions;   /*!< Number of introductions (single precision)        */
+  float*   _compact_first_invasion_age; /*!< Age of the first invasion (single precision)      */
+  float*   _compact_last_invasion_age;  /*!< Age of the last invasion (single precision)       */
+  
   /*--------------------------------------- SCORES */
   
   double _likelihood;             /*!< Fisher's likelihood         */
@@ -423,9 +455,18 @@ inline bool Node::isTagged( void ) const
  */
 inline bool Node::isOccupied( int rep ) const
 {
-  assert(rep >= 0);
-  assert(rep < _parameters->get_repetitions());
-  return (bool)_current_state[rep];
+  return (_compact ? isOccupied<COMPACT_LAYOUT>(rep) : isOccupied<STANDARD_LAYOUT>(rep));
+}
+
+/**
+ * \brief    Get the number of introductions for repetition rep
+ * \details  --
+ * \param    int rep
+ * \return   \e double
+ */
+inline double Node::get_nb_introductions( int rep ) const
+{
+  return (_compact ? get_nb_introductions<COMPACT_LAYOUT>(rep) : get_nb_introductions<STANDARD_LAYOUT>(rep));
 }
 
 /**
@@ -502,9 +543,7 @@ inline double Node::get_p_sim( void ) const
  */
 inline double Node::get_first_invasion_age( int rep ) const
 {
-  assert(rep >= 0);
-  assert(rep < _parameters->get_repetitions());
-  return _first_invasion_age[rep];
+  return (_compact ? get_first_invasion_age<COMPACT_LAYOUT>(rep) : get_first_invasion_age<STANDARD_LAYOUT>(rep));
 }
 
 /**
@@ -515,9 +554,7 @@ inline double Node::get_first_invasion_age( int rep ) const
  */
 inline double Node::get_last_invasion_age( int rep ) const
 {
-  assert(rep >= 0);
-  assert(rep < _parameters->get_repetitions());
-  return _last_invasion_age[rep];
+  return (_compact ? get_last_invasion_age<COMPACT_LAYOUT>(rep) : get_last_invasion_age<STANDARD_LAYOUT>(rep));
 }
 
 /**
@@ -564,6 +601,84 @@ inline double Node::get_var_last_invasion_age( void ) const
   return _var_last_invasion_age;
 }
 
+/**
+ * \brief    Get current state for repetition rep, in a given state layout
+ * \details  The layout is a compile time constant in the simulation kernels, which are specialized once by
+ *           layout (see Simulation::compute_jumps() and Graph::update_state()) instead of testing it in each
+ *           repetition
+ * \param    int rep
+ * \return   \e bool
+ */
+template <state_layout LAYOUT>
+inline bool Node::isOccupied( int rep ) const
+{
+  assert(rep >= 0);
+  assert(rep < _parameters->get_repetitions());
+  assert(_compact == (LAYOUT == COMPACT_LAYOUT));
+  if (LAYOUT == COMPACT_LAYOUT)
+  {
+    return (bool)(_packed_states[rep]&1);
+  }
+  return (bool)_current_state[rep];
+}
+
+/**
+ * \brief    Get the number of introductions for repetition rep, in a given state layout
+ * \details  See isOccupied<LAYOUT>()
+ * \param    int rep
+ * \return   \e double
+ */
+template <state_layout LAYOUT>
+inline double Node::get_nb_introductions( int rep ) const
+{
+  assert(rep >= 0);
+  assert(rep < _parameters->get_repetitions());
+  assert(_compact == (LAYOUT == COMPACT_LAYOUT));
+  if (LAYOUT == COMPACT_LAYOUT)
+  {
+    return (double)_compact_nb_introductions[rep];
+  }
+  return _nb_introductions[rep];
+}
+
+/**
+ * \brief    Get the age of the first invasion, in a given state layout
+ * \details  See isOccupied<LAYOUT>()
+ * \param    int rep
+ * \return   \e double
+ */
+template <state_layout LAYOUT>
+inline double Node::get_first_invasion_age( int rep ) const
+{
+  assert(rep >= 0);
+  assert(rep < _parameters->get_repetitions());
+  assert(_compact == (LAYOUT == COMPACT_LAYOUT));
+  if (LAYOUT == COMPACT_LAYOUT)
+  {
+    return (double)_compact_first_invasion_age[rep];
+  }
+  return _first_invasion_age[rep];
+}
+
+/**
+ * \brief    Get the age of the last invasion, in a given state layout
+ * \details  See isOccupied<LAYOUT>()
+ * \param    int rep
+ * \return   \e double
+ */
+template <state_layout LAYOUT>
+inline double Node::get_last_invasion_age( int rep ) const
+{
+  assert(rep >= 0);
+  assert(rep < _parameters->get_repetitions());
+  assert(_compact == (LAYOUT == COMPACT_LAYOUT));
+  if (LAYOUT == COMPACT_LAYOUT)
+  {
+    return (double)_compact_last_invasion_age[rep];
+  }
+  return _last_invasion_age[rep];
+}
+
 /*--------------------------------------- SCORES */
 
 /**
@@ -655,6 +770,21 @@ inline double Node::get_score( void ) const
 }
 
 
+/**
+ * \brief    Get the memory used by the states of a node in one repetition
+ * \details  --
+ * \param    state_layout layout
+ * \return   \e size_t
+ */
+inline size_t Node::get_bytes_by_repetition( state_layout layout )
+{
+  if (layout == COMPACT_LAYOUT)
+  {
+    return sizeof(uint8_t)+3*sizeof(float);
+  }
+  return 2*sizeof(int)+3*sizeof(double);
+}
+
 /*----------------------------
  * SETTERS
  *----------------------------*/
@@ -692,19 +822,37 @@ inline void Node::set_map_data( double x, double y, double node_area, double sui
 
 /*--------------------------------------- NETWORK */
 
+/**
+ * \brief    Reserve the neighbors list
+ * \details  Allocates the network arrays of the node at once, before its neighbors are added
+ * \param    int nb_neighbors
+ * \return   \e void
+ */
+inline void Node::reserve_neighbors( int nb_neighbors )
+{
+  assert(nb_neighbors >= 0);
+  _neighbors.reserve(nb_neighbors);
+  _roads.reserve(6*nb_neighbors);
+  _weights.reserve(nb_neighbors);
+}
+
 /**
  * \brief    Add a neighbor to the neighbors list
- * \details  --
- * \param    double weight
+ * \details  The six road categories lengths are kept to recompute the edge weight when road weights change
+ * \param    double* roads
  * \param    Node* node
  * \return   \e void
  */
-inline void Node::add_neighbor( double weight, Node* node )
+inline void Node::add_neighbor( double* roads, Node* node )
 {
-  assert(weight >= 0.0);
-  _weights.push_back(weight);
+  for (int i = 0; i < 6; i++)
+  {
+    assert(roads[i] >= 0.0);
+    _roads.push_back(roads[i]);
+  }
   _neighbors.push_back(node);
-  _weights_sum += weight;
+  _weights.push_back(compute_edge_weight(_neighbors.size()-1));
+  _weights_sum += _weights.back();
 }
 
 /**
@@ -775,11 +923,14 @@ inline void Node::untag( void )
  */
 inline void Node::add_introduction( int rep )
 {
-  assert(rep >= 0);
-  assert(rep < _parameters->get_repetitions());
-  _next_state[rep]         = 1;
-  _nb_introductions[rep]  += 1.0;
-  _total_nb_introductions += 1.0;
+  if (_compact)
+  {
+    add_introduction<COMPACT_LAYOUT>(rep);
+  }
+  else
+  {
+    add_introduction<STANDARD_LAYOUT>(rep);
+  }
 }
 
 /**
@@ -795,15 +946,12 @@ inline void Node::set_as_introduction_node( void )
   {
     if (_prng->uniform() < _parameters->get_p_introduction())
     {
-      _current_state[rep]     = 1;
-      _next_state[rep]        = 1;
-      _nb_introductions[rep] += 1.0;
-      _y_sim                 += 1.0;
+      set_repetition(rep, 1, 1, get_nb_introductions(rep)+1.0, get_first_invasion_age(rep), get_last_invasion_age(rep));
+      _y_sim += 1.0;
     }
     else
     {
-      _current_state[rep] = 0;
-      _next_state[rep]    = 0;
+      set_repetition(rep, 0, 0, get_nb_introductions(rep), get_first_invasion_age(rep), get_last_invasion_age(rep));
     }
   }
   _p_sim = _y_sim/_n_sim;
@@ -817,10 +965,65 @@ inline void Node::set_as_introduction_node( void )
  * \return   \e void
  */
 inline void Node::update_invasion_age( double age, int rep )
+{
+  if (_compact)
+  {
+    update_invasion_age<COMPACT_LAYOUT>(age, rep);
+  }
+  else
+  {
+    update_invasion_age<STANDARD_LAYOUT>(age, rep);
+  }
+}
+
+/**
+ * \brief    Add an introduction at repetition rep, in a given state layout
+ * \details  See isOccupied<LAYOUT>()
+ * \param    int rep
+ * \return   \e void
+ */
+template <state_layout LAYOUT>
+inline void Node::add_introduction( int rep )
+{
+  assert(rep >= 0);
+  assert(rep < _parameters->get_repetitions());
+  assert(_compact == (LAYOUT == COMPACT_LAYOUT));
+  if (LAYOUT == COMPACT_LAYOUT)
+  {
+    _packed_states[rep]            |= 2;
+    _compact_nb_introductions[rep] += 1.0f;
+  }
+  else
+  {
+    _next_state[rep]        = 1;
+    _nb_introductions[rep] += 1.0;
+  }
+  _total_nb_introductions += 1.0;
+}
+
+/**
+ * \brief    Update the age(s) of the invasion, in a given state layout
+ * \details  See isOccupied<LAYOUT>()
+ * \param    double age
+ * \param    int rep
+ * \return   \e void
+ */
+template <state_layout LAYOUT>
+inline void Node::update_invasion_age( double age, int rep )
 {
   assert(age >= 0.0);
   assert(rep >= 0);
   assert(rep < _parameters->get_repetitions());
+  assert(_compact == (LAYOUT == COMPACT_LAYOUT));
+  if (LAYOUT == COMPACT_LAYOUT)
+  {
+    if (_compact_first_invasion_age[rep] == -1.0f)
+    {
+      _compact_first_invasion_age[rep] = (float)age;
+    }
+    _compact_last_invasion_age[rep] = (float)age;
+    return;
+  }
   if (_first_invasion_age[rep] == -1.0)
   {
     _first_invasion_age[rep] = age;
@@ -829,4 +1032,59 @@ inline void Node::update_invasion_age( double age, int rep )
 }
 
 
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Compute the weight of an edge from its road categories
+ * \details  Linear combination of road categories lengths, bounded by the minimal weight
+ * \param    size_t edge
+ * \return   \e double
+ */
+inline double Node::compute_edge_weight( size_t edge ) const
+{
+  const double* roads  = &_roads[6*edge];
+  double        weight = 0.0;
+  weight += _parameters->get_w1()*roads[0];
+  weight += _parameters->get_w2()*roads[1];
+  weight += _parameters->get_w3()*roads[2];
+  weight += _parameters->get_w4()*roads[3];
+  weight += _parameters->get_w5()*roads[4];
+  weight += _parameters->get_w6()*roads[5];
+  weight  = (weight < _parameters->get_wmin() ? _parameters->get_wmin() : weight);
+  return weight;
+}
+
+/**
+ * \brief    Set the states, the number of introductions and the invasion ages of a repetition
+ * \details  Used outside of the hot path (initialization, introduction and checkpoints), whatever the layout
+ * \param    int rep
+ * \param    int current_state
+ * \param    int next_state
+ * \param    double nb_introductions
+ * \param    double first_invasion_age
+ * \param    double last_invasion_age
+ * \return   \e void
+ */
+inline void Node::set_repetition( int rep, int current_state, int next_state, double nb_introductions, double first_invasion_age, double last_invasion_age )
+{
+  if (_compact)
+  {
+    _packed_states[rep]              = (uint8_t)((current_state != 0 ? 1 : 0) | (next_state != 0 ? 2 : 0));
+    _compact_nb_introductions[rep]   = (float)nb_introductions;
+    _compact_first_invasion_age[rep] = (float)first_invasion_age;
+    _compact_last_invasion_age[rep]  = (float)last_invasion_age;
+  }
+  else
+  {
+    _current_state[rep]      = current_state;
+    _next_state[rep]         = next_state;
+    _nb_introductions[rep]   = nb_introductions;
+    _first_invasion_age[rep] = first_invasion_age;
+    _last_invasion_age[rep]  = last_invasion_age;
+  }
+}
+
+
 #endif /* defined(__MoRIS__Node__) */
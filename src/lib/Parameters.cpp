@@ -85,6 +85,15 @@ Parameters::Parameters( void )
   
   _save_outputs    = false;
   _save_all_states = false;
+  _save_history    = false;
+  _lineage_mode    = LINEAGE_EVENTS;
+  _raster_format   = NO_RASTER;
+  
+  /*------------------------------------------------------------------ Engine */
+  
+  _state_layout  = STANDARD_LAYOUT;
+  _memory_budget = 0.0;
+  _node_order    = DEFAULT_ORDER;
   
 }
 
@@ -109,6 +118,278 @@ Parameters::~Parameters( void )
  * PUBLIC METHODS
  *----------------------------*/
 
+/**
+ * \brief    Set a parameter from its command line name and a string value
+ * \details  Names are the MoRIS_run option names without leading dashes (e.g. "lambda", "w1").
+ *           Returns false if the name is unknown or the value is not valid.
+ * \param    std::string name
+ * \param    std::string value
+ * \return   \e bool
+ */
+bool Parameters::set_parameter( std::string name, std::string value )
+{
+  const char* str = value.c_str();
+  if (name == "seed")
+  {
+    set_prng_seed((unsigned)atol(str));
+  }
+  else if (name == "map")
+  {
+    set_map_filename(value);
+  }
+  else if (name == "network")
+  {
+    set_network_filename(value);
+  }
+  else if (name == "sample")
+  {
+    set_sample_filename(value);
+  }
+  else if (name == "typeofdata" || name == "type-of-data")
+  {
+    if (value == "PRESENCE_ONLY")
+    {
+      set_typeofdata(PRESENCE_ONLY);
+    }
+    else if (value == "PRESENCE_ABSENCE")
+    {
+      set_typeofdata(PRESENCE_ABSENCE);
+    }
+    else
+    {
+      return false;
+    }
+  }
+  else if (name == "reps")
+  {
+    if (atoi(str) <= 0)
+    {
+      return false;
+    }
+    set_repetitions(atoi(str));
+  }
+  else if (name == "iters")
+  {
+    if (atoi(str) <= 0)
+    {
+      return false;
+    }
+    set_iterations(atoi(str));
+  }
+  else if (name == "law")
+  {
+    if (value == "DIRAC")
+    {
+      set_jump_law(DIRAC);
+    }
+    else if (value == "NORMAL")
+    {
+      set_jump_law(NORMAL);
+    }
+    else if (value == "LOG_NORMAL")
+    {
+      set_jump_law(LOG_NORMAL);
+    }
+    else if (value == "CAUCHY")
+    {
+      set_jump_law(CAUCHY);
+    }
+    else
+    {
+      return false;
+    }
+  }
+  else if (name == "optimfunc")
+  {
+    if (value == "LSS")
+    {
+      set_optimization_function(LSS);
+    }
+    else if (value == "LOG_LIKELIHOOD")
+    {
+      set_optimization_function(LOG_LIKELIHOOD);
+    }
+    else if (value == "LIKELIHOOD_LSS")
+    {
+      set_optimization_function(LIKELIHOOD_LSS);
+    }
+    else
+    {
+      return false;
+    }
+  }
+  else if (name == "humanactivity")
+  {
+    if (value == "NO")
+    {
+      set_human_activity_index(false);
+    }
+    else if (value == "YES")
+    {
+      set_human_activity_index(true);
+    }
+    else
+    {
+      return false;
+    }
+  }
+  else if (name == "lineage")
+  {
+    if (value == "EVENTS")
+    {
+      set_lineage_mode(LINEAGE_EVENTS);
+    }
+    else if (value == "AGGREGATED")
+    {
+      set_lineage_mode(LINEAGE_AGGREGATED);
+    }
+    else if (value == "BINARY")
+    {
+      set_lineage_mode(LINEAGE_BINARY);
+    }
+    else
+    {
+      return false;
+    }
+  }
+  else if (name == "raster")
+  {
+    if (value == "NO")
+    {
+      set_raster_format(NO_RASTER);
+    }
+    else if (value == "ASC")
+    {
+      set_raster_format(ASCII_GRID);
+    }
+    else if (value == "FLT")
+    {
+      set_raster_format(FLOAT_GRID);
+    }
+    else
+    {
+      return false;
+    }
+  }
+  else if (name == "layout")
+  {
+    if (value == "STANDARD")
+    {
+      set_state_layout(STANDARD_LAYOUT);
+    }
+    else if (value == "COMPACT")
+    {
+      set_state_layout(COMPACT_LAYOUT);
+    }
+    else if (value == "AUTO")
+    {
+      set_state_layout(AUTO_LAYOUT);
+    }
+    else
+    {
+      return false;
+    }
+  }
+  else if (name == "order")
+  {
+    if (value == "DEFAULT")
+    {
+      set_node_order(DEFAULT_ORDER);
+    }
+    else if (value == "HILBERT")
+    {
+      set_node_order(HILBERT_ORDER);
+    }
+    else if (value == "RCM")
+    {
+      set_node_order(RCM_ORDER);
+    }
+    else
+    {
+      return false;
+    }
+  }
+  else if (name == "xintro")
+  {
+    set_x_introduction(atof(str));
+  }
+  else if (name == "yintro")
+  {
+    set_y_introduction(atof(str));
+  }
+  else if (name == "pintro")
+  {
+    if (atof(str) < 0.0 || atof(str) > 1.0)
+    {
+      return false;
+    }
+    set_p_introduction(atof(str));
+  }
+  else if (name == "lambda" || name == "mu" || name == "sigma" || name == "gamma")
+  {
+    if (atof(str) < 0.0)
+    {
+      return false;
+    }
+    if (name == "lambda")
+    {
+      set_lambda(atof(str));
+    }
+    else if (name == "mu")
+    {
+      set_mu(atof(str));
+    }
+    else if (name == "sigma")
+    {
+      set_sigma(atof(str));
+    }
+    else
+    {
+      set_gamma(atof(str));
+    }
+  }
+  else if (name == "w1" || name == "w2" || name == "w3" || name == "w4" || name == "w5" || name == "w6" || name == "wmin")
+  {
+    if (atof(str) < 0.0 || atof(str) > 1.0)
+    {
+      return false;
+    }
+    if (name == "w1")
+    {
+      set_w1(atof(str));
+    }
+    else if (name == "w2")
+    {
+      set_w2(atof(str));
+    }
+    else if (name == "w3")
+    {
+      set_w3(atof(str));
+    }
+    else if (name == "w4")
+    {
+      set_w4(atof(str));
+    }
+    else if (name == "w5")
+    {
+      set_w5(atof(str));
+    }
+    else if (name == "w6")
+    {
+      set_w6(atof(str));
+    }
+    else
+    {
+      set_wmin(atof(str));
+    }
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
 /**
  * \brief    Write parameters in a file
  * \details  --
@@ -120,7 +401,7 @@ void Parameters::write_parameters( std::string filename )
   /*~~~~~~~~~~~~~~~~~*/
   /* 1) Open file    */
   /*~~~~~~~~~~~~~~~~~*/
-  std::ofstream file(filename, std::ios::out | std::ios::trunc);
+  TextWriter file(filename);
   
   /*~~~~~~~~~~~~~~~~~*/
   /* 2) Write header */
@@ -150,7 +431,12 @@ void Parameters::write_parameters( std::string filename )
   file << "w6" << " ";
   file << "wmin" << " ";
   file << "save-outputs" << " ";
-  file << "save-all-states" << "\n";
+  file << "save-all-states" << " ";
+  file << "save-history" << " ";
+  file << "lineage" << " ";
+  file << "raster" << " ";
+  file << "layout" << " ";
+  file << "order" << "\n";
   
   /*~~~~~~~~~~~~~~~~~*/
   /* 3) Write data   */
@@ -220,7 +506,34 @@ void Parameters::write_parameters( std::string filename )
   file << _w6 << " ";
   file << _wmin << " ";
   file << _save_outputs << " ";
-  file << _save_all_states << "\n";
+  file << _save_all_states << " ";
+  file << _save_history << " ";
+  if (_lineage_mode == LINEAGE_EVENTS)
+  {
+    file << "EVENTS" << " ";
+  }
+  else if (_lineage_mode == LINEAGE_AGGREGATED)
+  {
+    file << "AGGREGATED" << " ";
+  }
+  else if (_lineage_mode == LINEAGE_BINARY)
+  {
+    file << "BINARY" << " ";
+  }
+  if (_raster_format == NO_RASTER)
+  {
+    file << "NO" << " ";
+  }
+  else if (_raster_format == ASCII_GRID)
+  {
+    file << "ASC" << " ";
+  }
+  else if (_raster_format == FLOAT_GRID)
+  {
+    file << "FLT" << " ";
+  }
+  file << (_state_layout == COMPACT_LAYOUT ? "COMPACT" : "STANDARD") << " ";
+  file << (_node_order == HILBERT_ORDER ? "HILBERT" : (_node_order == RCM_ORDER ? "RCM" : "DEFAULT")) << "\n";
   
   /*---------------*/
   /* 4) Close file */
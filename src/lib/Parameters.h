@@ -40,6 +40,7 @@
 
 #include "Prng.h"
 #include "Enums.h"
+#include "TextWriter.h"
 
 
 class Parameters
@@ -108,6 +109,13 @@ public:
   inline bool saveOutputs( void ) const;
   inline bool get_save_all_states( void ) const;
   inline bool saveAllStates( void ) const;
+  inline bool get_save_history( void ) const;
+  inline bool saveHistory( void ) const;
+  inline lineage_mode get_lineage_mode( void ) const;
+  inline raster_format get_raster_format( void ) const;
+  inline state_layout  get_state_layout( void ) const;
+  inline double        get_memory_budget( void ) const;
+  inline node_order    get_node_order( void ) const;
   
   /*----------------------------
    * SETTERS
@@ -157,10 +165,17 @@ public:
   
   inline void set_save_outputs( bool save_outputs );
   inline void set_save_all_states( bool save_all_states );
+  inline void set_save_history( bool save_history );
+  inline void set_lineage_mode( lineage_mode mode );
+  inline void set_raster_format( raster_format format );
+  inline void set_state_layout( state_layout layout );
+  inline void set_memory_budget( double memory_budget );
+  inline void set_node_order( node_order order );
   
   /*----------------------------
    * PUBLIC METHODS
    *----------------------------*/
+  bool set_parameter( std::string name, std::string value );
   void write_parameters( std::string filename );
   
   /*----------------------------
@@ -220,8 +235,17 @@ protected:
   
   /*------------------------------------------------------------------ Extra statistics */
   
-  bool _save_outputs;    /*!< Save simulation outputs    */
-  bool _save_all_states; /*!< Save all simulation states */
+  bool          _save_outputs;    /*!< Save simulation outputs    */
+  bool          _save_all_states; /*!< Save all simulation states */
+  bool          _save_history;    /*!< Save the state history    */
+  lineage_mode  _lineage_mode;    /*!< Lineage tree output mode  */
+  raster_format _raster_format;   /*!< Raster output format       */
+  
+  /*------------------------------------------------------------------ Engine */
+  
+  state_layout _state_layout;  /*!< Layout of the node states by repetition    */
+  double       _memory_budget; /*!< Memory budget in MB (0 for no budget)       */
+  node_order   _node_order;    /*!< Order of the nodes in memory and in loops */
   
 };
 
@@ -561,6 +585,83 @@ inline bool Parameters::saveAllStates( void ) const
   return _save_all_states;
 }
 
+/**
+ * \brief    Get save the binary state history
+ * \details  --
+ * \param    void
+ * \return   \e bool
+ */
+inline bool Parameters::get_save_history( void ) const
+{
+  return _save_history;
+}
+
+/**
+ * \brief    Save the binary state history?
+ * \details  --
+ * \param    void
+ * \return   \e bool
+ */
+inline bool Parameters::saveHistory( void ) const
+{
+  return _save_history;
+}
+
+/**
+ * \brief    Get the lineage tree output mode
+ * \details  --
+ * \param    void
+ * \return   \e lineage_mode
+ */
+inline lineage_mode Parameters::get_lineage_mode( void ) const
+{
+  return _lineage_mode;
+}
+
+/**
+ * \brief    Get the raster output format
+ * \details  --
+ * \param    void
+ * \return   \e raster_format
+ */
+inline raster_format Parameters::get_raster_format( void ) const
+{
+  return _raster_format;
+}
+
+/**
+ * \brief    Get the layout of the node states by repetition
+ * \details  --
+ * \param    void
+ * \return   \e state_layout
+ */
+inline state_layout Parameters::get_state_layout( void ) const
+{
+  return _state_layout;
+}
+
+/**
+ * \brief    Get the memory budget of the simulation, in MB
+ * \details  0 for no budget
+ * \param    void
+ * \return   \e double
+ */
+inline double Parameters::get_memory_budget( void ) const
+{
+  return _memory_budget;
+}
+
+/**
+ * \brief    Get the order of the nodes in memory and in the simulation loop
+ * \details  --
+ * \param    void
+ * \return   \e node_order
+ */
+inline node_order Parameters::get_node_order( void ) const
+{
+  return _node_order;
+}
+
 /*----------------------------
  * SETTERS
  *----------------------------*/
@@ -886,5 +987,72 @@ inline void Parameters::set_save_all_states( bool save_all_states )
   _save_all_states = save_all_states;
 }
 
+/**
+ * \brief    Set save the binary state history
+ * \details  --
+ * \param    bool save_history
+ * \return   \e void
+ */
+inline void Parameters::set_save_history( bool save_history )
+{
+  _save_history = save_history;
+}
+
+/**
+ * \brief    Set the lineage tree output mode
+ * \details  --
+ * \param    lineage_mode mode
+ * \return   \e void
+ */
+inline void Parameters::set_lineage_mode( lineage_mode mode )
+{
+  _lineage_mode = mode;
+}
+
+/**
+ * \brief    Set the raster output format
+ * \details  --
+ * \param    raster_format format
+ * \return   \e void
+ */
+inline void Parameters::set_raster_format( raster_format format )
+{
+  _raster_format = format;
+}
+
+/**
+ * \brief    Set the layout of the node states by repetition
+ * \details  --
+ * \param    state_layout layout
+ * \return   \e void
+ */
+inline void Parameters::set_state_layout( state_layout layout )
+{
+  _state_layout = layout;
+}
+
+/**
+ * \brief    Set the memory budget of the simulation, in MB
+ * \details  0 for no budget
+ * \param    double memory_budget
+ * \return   \e void
+ */
+inline void Parameters::set_memory_budget( double memory_budget )
+{
+  assert(memory_budget >= 0.0);
+  _memory_budget = memory_budget;
+}
+
+/**
+ * \brief    Set the order of the nodes in memory and in the simulation loop
+ * \details  --
+ * \param    node_order order
+ * \return   \e void
+ */
+inline void Parameters::set_node_order( node_order order )
+{
+  _node_order = order;
+}
+
 
 #endif /* defined(__MoRIS__Parameters__) */
@@ -245,6 +245,38 @@ int Prng::roulette_wheel( double* probas, double sum, int N )
   exit(EXIT_FAILURE);
 }
 
+/**
+ * \brief    Write the generator state in a binary file
+ * \details  Writes the size of the state, then the raw GSL state. Drawing numbers after read_state() gives
+ *           the same sequence as drawing them after write_state().
+ * \param    std::ofstream& file
+ * \return   \e void
+ */
+void Prng::write_state( std::ofstream& file ) const
+{
+  uint64_t size = (uint64_t)gsl_rng_size(_prng);
+  file.write((const char*)&size, sizeof(uint64_t));
+  file.write((const char*)gsl_rng_state(_prng), (std::streamsize)size);
+}
+
+/**
+ * \brief    Read the generator state from a binary file
+ * \details  The state must come from a generator of the same type (see write_state())
+ * \param    std::ifstream& file
+ * \return   \e void
+ */
+void Prng::read_state( std::ifstream& file )
+{
+  uint64_t size = 0;
+  file.read((char*)&size, sizeof(uint64_t));
+  if (!file || size != (uint64_t)gsl_rng_size(_prng))
+  {
+    std::cout << "Error: the saved generator state does not match the generator type.\n";
+    exit(EXIT_FAILURE);
+  }
+  file.read((char*)gsl_rng_state(_prng), (std::streamsize)size);
+}
+
 /*----------------------------
  * PROTECTED METHODS
  *----------------------------*/
@@ -30,6 +30,8 @@
 #define __MoRIS__Prng__
 
 #include <iostream>
+#include <fstream>
+#include <cstdint>
 #include <cmath>
 #include <cstring>
 #include <stdlib.h>
@@ -81,6 +83,8 @@ public:
   int    exponential( double mu );
   int    poisson( double lambda );
   int    roulette_wheel( double* probas, double sum, int N );
+  void   write_state( std::ofstream& file ) const;
+  void   read_state( std::ifstream& file );
   
   /*----------------------------
    * PUBLIC ATTRIBUTES
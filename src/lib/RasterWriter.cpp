@@ -0,0 +1,274 @@
+/**
+ * \file      RasterWriter.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     RasterWriter class definition
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "RasterWriter.h"
+
+
+/*----------------------------
+ * CONSTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Constructor
+ * \details  Detects the regular grid of a captured state from the node coordinates (cell centroids). The
+ *           spacing is the smallest gap between distinct coordinates, and must be the same along both axes.
+ *           Every node must fall on a distinct grid cell, otherwise the program stops.
+ * \param    const std::vector<int>& identifiers
+ * \param    const std::vector<double>& values
+ * \return   \e void
+ */
+RasterWriter::RasterWriter( const std::vector<int>& identifiers, const std::vector<double>& values )
+{
+  assert(identifiers.size() > 0);
+  assert(values.size() == identifiers.size()*Graph::STATE_VALUES);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Get the coordinates and bounds   */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  size_t              nb_nodes = identifiers.size();
+  std::vector<double> x(nb_nodes, 0.0);
+  std::vector<double> y(nb_nodes, 0.0);
+  for (size_t i = 0; i < nb_nodes; i++)
+  {
+    x[i] = values[i*Graph::STATE_VALUES];
+    y[i] = values[i*Graph::STATE_VALUES+1];
+  }
+  double xmin = *std::min_element(x.begin(), x.end());
+  double xmax = *std::max_element(x.begin(), x.end());
+  double ymin = *std::min_element(y.begin(), y.end());
+  double ymax = *std::max_element(y.begin(), y.end());
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Detect the grid spacing          */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  double tolerance = 1e-9*std::max(std::max(fabs(xmin), fabs(xmax)), std::max(std::max(fabs(ymin), fabs(ymax)), 1.0));
+  double dx        = detect_spacing(x, tolerance);
+  double dy        = detect_spacing(y, tolerance);
+  if (dx == 0.0 && dy == 0.0)
+  {
+    dx = dy = 1.0;
+  }
+  else if (dx == 0.0 || dy == 0.0)
+  {
+    dx = dy = (dx > dy ? dx : dy);
+  }
+  if (fabs(dx-dy) > 1e-6*dx)
+  {
+    std::cout << "Error: raster cells are not square (spacing " << dx << " along x, " << dy << " along y).\n";
+    exit(EXIT_FAILURE);
+  }
+  _cell_size = dx;
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Define the grid                  */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  double nb_columns = floor((xmax-xmin)/_cell_size+0.5)+1.0;
+  double nb_rows    = floor((ymax-ymin)/_cell_size+0.5)+1.0;
+  if (nb_columns*nb_rows > 1e9)
+  {
+    std::cout << "Error: raster grid is too large (" << nb_columns << " x " << nb_rows << " cells).\n";
+    exit(EXIT_FAILURE);
+  }
+  _nb_columns = (int)nb_columns;
+  _nb_rows    = (int)nb_rows;
+  _xllcorner  = xmin-_cell_size/2.0;
+  _yllcorner  = ymin-_cell_size/2.0;
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 4) Locate each node in the grid     */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<bool> used((size_t)_nb_columns*_nb_rows, false);
+  _cells.resize(nb_nodes);
+  for (size_t i = 0; i < nb_nodes; i++)
+  {
+    double column = floor((x[i]-xmin)/_cell_size+0.5);
+    double row    = floor((y[i]-ymin)/_cell_size+0.5);
+    if (fabs(xmin+column*_cell_size-x[i]) > 1e-3*_cell_size || fabs(ymin+row*_cell_size-y[i]) > 1e-3*_cell_size)
+    {
+      std::cout << "Error: node " << identifiers[i] << " is not on a regular grid (spacing " << _cell_size << ").\n";
+      exit(EXIT_FAILURE);
+    }
+    size_t cell = (size_t)(_nb_rows-1-(int)row)*_nb_columns+(size_t)column;
+    if (used[cell])
+    {
+      std::cout << "Error: node " << identifiers[i] << " shares its raster cell with another node.\n";
+      exit(EXIT_FAILURE);
+    }
+    used[cell] = true;
+    _cells[i]  = cell;
+  }
+}
+
+/*----------------------------
+ * DESTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Destructor
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+RasterWriter::~RasterWriter( void )
+{
+  _cells.clear();
+}
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Write a state value as a raster
+ * \details  The captured state must have the nodes of the one used to build the grid, in the same order.
+ *           ASCII_GRID writes basename.asc, FLOAT_GRID writes basename.flt (float32, rows from the north)
+ *           and its header basename.hdr. Cells without node are set to NODATA.
+ * \param    std::string basename
+ * \param    raster_format format
+ * \param    const std::vector<double>& values
+ * \param    int value_index
+ * \return   \e void
+ */
+void RasterWriter::write( std::string basename, raster_format format, const std::vector<double>& values, int value_index )
+{
+  assert(values.size() == _cells.size()*Graph::STATE_VALUES);
+  assert(value_index >= 0);
+  assert(value_index < Graph::STATE_VALUES);
+  std::vector<double> grid((size_t)_nb_columns*_nb_rows, (double)NODATA);
+  for (size_t i = 0; i < _cells.size(); i++)
+  {
+    grid[_cells[i]] = values[i*Graph::STATE_VALUES+value_index];
+  }
+  if (format == ASCII_GRID)
+  {
+    write_ascii_grid(basename+".asc", grid);
+  }
+  else if (format == FLOAT_GRID)
+  {
+    write_float_grid(basename, grid);
+  }
+}
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Detect the spacing of grid coordinates
+ * \details  Smallest gap between two distinct coordinates (0 if all the coordinates are equal)
+ * \param    std::vector<double> coordinates
+ * \param    double tolerance
+ * \return   \e double
+ */
+double RasterWriter::detect_spacing( std::vector<double> coordinates, double tolerance )
+{
+  std::sort(coordinates.begin(), coordinates.end());
+  double spacing = 0.0;
+  for (size_t i = 1; i < coordinates.size(); i++)
+  {
+    double gap = coordinates[i]-coordinates[i-1];
+    if (gap > tolerance && (spacing == 0.0 || gap < spacing))
+    {
+      spacing = gap;
+    }
+  }
+  return spacing;
+}
+
+/**
+ * \brief    Write an ESRI ASCII grid
+ * \details  --
+ * \param    std::string filename
+ * \param    const std::vector<double>& grid
+ * \return   \e void
+ */
+void RasterWriter::write_ascii_grid( std::string filename, const std::vector<double>& grid )
+{
+  TextWriter file(filename);
+  if (!file.is_open())
+  {
+    std::cout << "Error: unable to open raster file " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  file << "ncols " << _nb_columns << '\n';
+  file << "nrows " << _nb_rows << '\n';
+  file << "xllcorner " << _xllcorner << '\n';
+  file << "yllcorner " << _yllcorner << '\n';
+  file << "cellsize " << _cell_size << '\n';
+  file << "NODATA_value " << NODATA << '\n';
+  const double* value = grid.data();
+  for (int row = 0; row < _nb_rows; row++)
+  {
+    for (int column = 0; column < _nb_columns; column++)
+    {
+      if (column > 0)
+      {
+        file << ' ';
+      }
+      file << *value++;
+    }
+    file << '\n';
+  }
+  file.close();
+}
+
+/**
+ * \brief    Write an ESRI binary float grid
+ * \details  Values are written as float32 in native byte order, given by the byteorder field of the header
+ * \param    std::string basename
+ * \param    const std::vector<double>& grid
+ * \return   \e void
+ */
+void RasterWriter::write_float_grid( std::string basename, const std::vector<double>& grid )
+{
+  uint16_t byte_order = 1;
+  bool     lsb_first  = (*(const char*)&byte_order == 1);
+  TextWriter header(basename+".hdr");
+  if (!header.is_open())
+  {
+    std::cout << "Error: unable to open raster file " << basename << ".hdr.\n";
+    exit(EXIT_FAILURE);
+  }
+  header << "ncols " << _nb_columns << '\n';
+  header << "nrows " << _nb_rows << '\n';
+  header << "xllcorner " << _xllcorner << '\n';
+  header << "yllcorner " << _yllcorner << '\n';
+  header << "cellsize " << _cell_size << '\n';
+  header << "NODATA_value " << NODATA << '\n';
+  header << "byteorder " << (lsb_first ? "LSBFIRST" : "MSBFIRST") << '\n';
+  header.close();
+  std::ofstream file(basename+".flt", std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!file)
+  {
+    std::cout << "Error: unable to open raster file " << basename << ".flt.\n";
+    exit(EXIT_FAILURE);
+  }
+  std::vector<float> values(grid.begin(), grid.end());
+  file.write((const char*)values.data(), values.size()*sizeof(float));
+  file.close();
+}
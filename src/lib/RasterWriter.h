@@ -0,0 +1,157 @@
+/**
+ * \file      RasterWriter.h
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     RasterWriter class declaration
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef __MoRIS__RasterWriter__
+#define __MoRIS__RasterWriter__
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "Enums.h"
+#include "Graph.h"
+#include "TextWriter.h"
+
+
+class RasterWriter
+{
+  
+public:
+  
+  /*----------------------------
+   * CONSTRUCTORS
+   *----------------------------*/
+  RasterWriter( void ) = delete;
+  RasterWriter( const std::vector<int>& identifiers, const std::vector<double>& values );
+  RasterWriter( const RasterWriter& writer ) = delete;
+  
+  /*----------------------------
+   * DESTRUCTORS
+   *----------------------------*/
+  ~RasterWriter( void );
+  
+  /*----------------------------
+   * GETTERS
+   *----------------------------*/
+  inline int    get_number_of_columns( void ) const;
+  inline int    get_number_of_rows( void ) const;
+  inline double get_cell_size( void ) const;
+  
+  /*----------------------------
+   * SETTERS
+   *----------------------------*/
+  RasterWriter& operator=(const RasterWriter&) = delete;
+  
+  /*----------------------------
+   * PUBLIC METHODS
+   *----------------------------*/
+  void write( std::string basename, raster_format format, const std::vector<double>& values, int value_index );
+  
+  /*----------------------------
+   * PUBLIC ATTRIBUTES
+   *----------------------------*/
+  static const int NODATA = -9999; /*!< Value of the cells without node */
+  
+protected:
+  
+  /*----------------------------
+   * PROTECTED METHODS
+   *----------------------------*/
+  double detect_spacing( std::vector<double> coordinates, double tolerance );
+  void   write_ascii_grid( std::string filename, const std::vector<double>& grid );
+  void   write_float_grid( std::string basename, const std::vector<double>& grid );
+  
+  /*----------------------------
+   * PROTECTED ATTRIBUTES
+   *----------------------------*/
+  
+  /*--------------------------------------- GRID */
+  
+  int    _nb_columns; /*!< Number of columns                     */
+  int    _nb_rows;    /*!< Number of rows                        */
+  double _xllcorner;  /*!< X coordinate of the lower left corner */
+  double _yllcorner;  /*!< Y coordinate of the lower left corner */
+  double _cell_size;  /*!< Cell size                             */
+  
+  /*--------------------------------------- NODES */
+  
+  std::vector<size_t> _cells; /*!< Grid cell of each node, in capture order (rows from the north) */
+  
+};
+
+
+/*----------------------------
+ * GETTERS
+ *----------------------------*/
+
+/**
+ * \brief    Get the number of columns of the grid
+ * \details  --
+ * \param    void
+ * \return   \e int
+ */
+inline int RasterWriter::get_number_of_columns( void ) const
+{
+  return _nb_columns;
+}
+
+/**
+ * \brief    Get the number of rows of the grid
+ * \details  --
+ * \param    void
+ * \return   \e int
+ */
+inline int RasterWriter::get_number_of_rows( void ) const
+{
+  return _nb_rows;
+}
+
+/**
+ * \brief    Get the cell size of the grid
+ * \details  --
+ * \param    void
+ * \return   \e double
+ */
+inline double RasterWriter::get_cell_size( void ) const
+{
+  return _cell_size;
+}
+
+/*----------------------------
+ * SETTERS
+ *----------------------------*/
+
+
+#endif /* defined(__MoRIS__RasterWriter__) */
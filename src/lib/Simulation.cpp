@@ -46,20 +46,20 @@ Simulation::Simulation( Parameters* parameters )
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
   /* 1) Initialize the simulation  */
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-  _parameters = parameters;
-  _prng       = parameters->get_prng();
-  _graph      = new Graph(_parameters);
-  _iteration  = 0;
+  _parameters    = parameters;
+  _prng          = parameters->get_prng();
+  _graph         = new Graph(_parameters);
+  _iteration     = 0;
+  _nb_jumps      = 0;
+  _nb_walk_steps = 0;
+  _walk_histograms.assign(6*WALK_HISTOGRAM_BINS, 0);
   
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
   /* 2) Save lineage tree if asked */
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-  if (_parameters->saveOutputs())
-  {
-    std::ofstream tree_file("output/lineage_tree.txt", std::ios::out | std::ios::trunc);
-    tree_file << "repetition start_node end_node geodesic_dist euclidean_dist iteration\n";
-    tree_file.close();
-  }
+  _lineage_writer = NULL;
+  _lineage_size   = 0;
+  initialize_lineage();
 }
 
 /*----------------------------
@@ -74,6 +74,12 @@ Simulation::Simulation( Parameters* parameters )
  */
 Simulation::~Simulation( void )
 {
+  if (_tree_file.is_open())
+  {
+    _tree_file.close();
+  }
+  delete _lineage_writer;
+  _lineage_writer = NULL;
   delete _graph;
   _graph = NULL;
 }
@@ -82,21 +88,75 @@ Simulation::~Simulation( void )
  * PUBLIC METHODS
  *----------------------------*/
 
+/**
+ * \brief    Reinitialize the simulation with the current parameters
+ * \details  The graph is reused: input files are not reloaded (see Graph::reinitialize())
+ * \param    void
+ * \return   \e void
+ */
+void Simulation::reinitialize( void )
+{
+  _graph->reinitialize();
+  _iteration     = 0;
+  _nb_jumps      = 0;
+  _nb_walk_steps = 0;
+  _walk_histograms.assign(6*WALK_HISTOGRAM_BINS, 0);
+  initialize_lineage();
+}
+
 /**
  * \brief    Compute the next iteration
- * \details  --
+ * \details  Runs the jumps of all the occupied cells, then updates the cell states
  * \param    void
  * \return   \e void
  */
 void Simulation::compute_next_iteration( void )
 {
-  std::ofstream tree_file;
-  if (_parameters->saveOutputs())
+  compute_jumps();
+  update_state();
+}
+
+/**
+ * \brief    Run the jumps of the current iteration
+ * \details  Introductions are only applied to the cell states by update_state(). The two steps are exposed
+ *           separately to time them (see MoRIS_bench), and must always be called in this order. The state
+ *           layout is tested once, and the jumps run in the kernel of this layout (see run_jumps()).
+ * \param    void
+ * \return   \e void
+ */
+void Simulation::compute_jumps( void )
+{
+  if (_parameters->get_state_layout() == COMPACT_LAYOUT)
+  {
+    run_jumps<COMPACT_LAYOUT>();
+  }
+  else
   {
-    tree_file.open("output/lineage_tree.txt", std::ios::out | std::ios::app);
+    run_jumps<STANDARD_LAYOUT>();
   }
+}
+
+/**
+ * \brief    Run the jumps of the current iteration, in a given state layout
+ * \details  See compute_jumps()
+ * \param    void
+ * \return   \e void
+ */
+template <state_layout LAYOUT>
+void Simulation::run_jumps( void )
+{
+  bool save_events     = (_parameters->saveOutputs() && _parameters->get_lineage_mode() == LINEAGE_EVENTS);
+  bool save_aggregated = (_parameters->saveOutputs() && _parameters->get_lineage_mode() == LINEAGE_AGGREGATED);
+  bool save_walks      = _parameters->saveOutputs();
   std::vector<Node*> tagged_nodes;
   tagged_nodes.reserve(sizeof(Node*)*_graph->get_number_of_nodes());
+  open_lineage();
+  MORIS_TIMER_START(JUMP_PHASE);
+  MORIS_TRACE_BEGIN("jump_phase");
+#ifdef MORIS_TRACING
+  long first_jumps      = _nb_jumps;
+  long first_walk_steps = _nb_walk_steps;
+#endif
   
   /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
   /* 1) For each node of the graph and each repetition */
@@ -109,28 +169,44 @@ void Simulation::compute_next_iteration( void )
     /*-----------------------------------------------*/
     for (int rep = 0; rep < _parameters->get_repetitions(); rep++)
     {
-      if (start_node->isOccupied(rep))
+      if (start_node->isOccupied<LAYOUT>(rep))
       {
         int number_of_jumps = draw_number_of_jumps(start_node->get_human_activity_index());
+        _nb_jumps          += number_of_jumps;
+        MORIS_COUNT(JUMPS_DRAWN, number_of_jumps);
         for (int jump = 0; jump < number_of_jumps; jump++)
         {
           Node*  current_node     = start_node;
           int    current_id       = current_node->get_identifier();
           double distance         = draw_jump_size();
           double current_distance = 0.0;
+          bool   trapped          = false;
+          double trapped_distance = 0.0;
+          size_t trapped_steps    = 0;
           while (current_distance < distance)
           {
             current_node->tag();
             tagged_nodes.push_back(current_node);
             current_node = current_node->jump();
+            MORIS_COUNT(WALK_STEPS, 1);
+            MORIS_COUNT(TRAPPED_STEPS, (current_node == tagged_nodes.back()));
+            /*** Record the first dead end (the walk goes on in place) ***/
+            if (!trapped && current_node != NULL && current_node == tagged_nodes.back())
+            {
+              trapped          = true;
+              trapped_distance = current_distance;
+              trapped_steps    = tagged_nodes.size();
+            }
             /*** If the current node is out of the map, stop walking ***/
             if (current_node == NULL)
             {
+              MORIS_COUNT(WALKS_LEFT_MAP, 1);
               break;
             }
             /*** If the current node is self, stop walking ***/
             else if (current_node->get_identifier() == current_id)
             {
+              MORIS_COUNT(WALKS_TRAPPED_AT_START, 1);
               break;
             }
             /*** Else increment the distance ***/
@@ -139,14 +215,30 @@ void Simulation::compute_next_iteration( void )
               current_distance += 1.0;
             }
           }
+          MORIS_COUNT(WALKS_TRAPPED, trapped);
+          MORIS_COUNT(WALKS_COMPLETED, (!trapped && current_distance >= distance));
+          MORIS_MAXIMUM(PEAK_TAGGED_NODES, tagged_nodes.size());
+          _nb_walk_steps += (long)tagged_nodes.size();
+          if (save_walks)
+          {
+            add_walk(distance, (trapped ? trapped_distance : current_distance), (trapped ? trapped_steps : tagged_nodes.size()), (current_node == NULL), trapped);
+          }
           if (current_node != NULL)
           {
-            current_node->add_introduction(rep);
-            current_node->update_invasion_age((double)_iteration, rep);
-            if (_parameters->saveOutputs())
+            current_node->add_introduction<LAYOUT>(rep);
+            current_node->update_invasion_age<LAYOUT>((double)_iteration, rep);
+            if (save_events)
             {
               double euclidean_dist = compute_euclidean_distance(start_node, current_node);
-              tree_file << rep+1 << " " << start_node->get_identifier() << " " << current_node->get_identifier() << " " << current_distance << " " << euclidean_dist << " " << _iteration << "\n";
+              _tree_file << rep+1 << ' ' << start_node->get_identifier() << ' ' << current_node->get_identifier() << ' ' << current_distance << ' ' << euclidean_dist << ' ' << _iteration << '\n';
+            }
+            else if (save_aggregated)
+            {
+              add_lineage_flow(start_node, current_node, current_distance, compute_euclidean_distance(start_node, current_node));
+            }
+            else if (_lineage_writer != NULL)
+            {
+              _lineage_writer->add_event(rep+1, start_node->get_identifier(), current_node->get_identifier(), current_distance, compute_euclidean_distance(start_node, current_node), _iteration);
             }
           }
           for (size_t i = 0; i < tagged_nodes.size(); i++)
@@ -163,15 +255,25 @@ void Simulation::compute_next_iteration( void )
     /*-----------------------------------------------*/
     start_node = _graph->get_next();
   }
-  if (_parameters->saveOutputs())
-  {
-    tree_file.close();
-  }
-  
-  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-  /* 2) Update all the cell states                     */
-  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  _lineage_index.clear();
+  MORIS_TRACE_END("jump_phase", "jumps", _nb_jumps-first_jumps, "walk_steps", _nb_walk_steps-first_walk_steps);
+  MORIS_TIMER_STOP(JUMP_PHASE);
+}
+
+/**
+ * \brief    Update all the cell states and close the current iteration
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void Simulation::update_state( void )
+{
+  MORIS_TIMER_START(UPDATE_STATE_PHASE);
+  MORIS_TRACE_BEGIN("update_state");
   _graph->update_state();
+  MORIS_TRACE_END("update_state", "iteration", _iteration);
+  MORIS_TIMER_STOP(UPDATE_STATE_PHASE);
+  MORIS_COUNT(ITERATIONS, 1);
   _iteration++;
 }
 
@@ -183,7 +285,11 @@ void Simulation::compute_next_iteration( void )
  */
 void Simulation::compute_score( void )
 {
+  MORIS_TIMER_START(SCORE_PHASE);
+  MORIS_TRACE_BEGIN("score");
   _graph->compute_score(false);
+  MORIS_TRACE_END("score");
+  MORIS_TIMER_STOP(SCORE_PHASE);
 }
 
 /**
@@ -198,15 +304,279 @@ void Simulation::write_state( std::string filename )
 }
 
 /**
- * \brief    Write unique pairs of occupied nodes with euclidean distances
+ * \brief    Capture simulation state
+ * \details  --
+ * \param    std::vector<int>& identifiers
+ * \param    std::vector<double>& values
+ * \return   \e void
+ */
+void Simulation::capture_state( std::vector<int>& identifiers, std::vector<double>& values )
+{
+  _graph->capture_state(identifiers, values);
+}
+
+/**
+ * \brief    Write the euclidean distance histograms of unique pairs of occupied nodes
  * \details  --
  * \param    std::string observed_filename
  * \param    std::string simulated_filename
+ * \param    int nb_bins
+ * \return   \e void
+ */
+void Simulation::write_invasion_euclidean_distributions( std::string observed_filename, std::string simulated_filename, int nb_bins )
+{
+  _graph->write_invasion_euclidean_distributions(observed_filename, simulated_filename, nb_bins);
+}
+
+/**
+ * \brief    Write the invasion time series
+ * \details  Only recorded when outputs are saved
+ * \param    std::string filename
+ * \return   \e void
+ */
+void Simulation::write_invasion_time_series( std::string filename )
+{
+  _graph->write_invasion_time_series(filename);
+}
+
+/**
+ * \brief    Save a checkpoint of the simulation
+ * \details  The binary file starts with the header "MoRISCKP", the format version, the current iteration, the
+ *           number of repetitions, the output options, the state layout, the node order, and the hashes of
+ *           the model parameters and of the node identifiers sequence (see compute_checkpoint_hashes()). It
+ *           then holds the Prng state, the node states (see Graph::write_checkpoint()), the aggregated
+ *           lineage flows, the size of the lineage file and the walk histograms. A run resumed from the
+ *           checkpoint (see load_checkpoint()) is identical to an uninterrupted one. The file is first
+ *           written under a temporary name, then renamed, so that an interrupted save does not corrupt the
+ *           previous checkpoint.
+ * \param    std::string filename
+ * \return   \e void
+ */
+void Simulation::save_checkpoint( std::string filename )
+{
+  std::string   temporary = filename+".tmp";
+  std::ofstream file(temporary, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!file)
+  {
+    std::cout << "Error: unable to open checkpoint file " << temporary << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Write the header            */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  int32_t  header[7] = {(int32_t)CHECKPOINT_VERSION, (int32_t)_iteration, (int32_t)_parameters->get_repetitions(), (int32_t)_parameters->saveOutputs(), (int32_t)_parameters->get_lineage_mode(), (int32_t)_parameters->get_state_layout(), (int32_t)_parameters->get_node_order()};
+  uint64_t hashes[2] = {0, 0};
+  compute_checkpoint_hashes(hashes);
+  file.write("MoRISCKP", 8);
+  file.write((const char*)header, sizeof(header));
+  file.write((const char*)hashes, sizeof(hashes));
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Write the simulation state  */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  _prng->write_state(file);
+  _graph->write_checkpoint(file);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Write the lineage state     */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  uint64_t nb_flows = (uint64_t)_lineage_start.size();
+  int64_t  size     = (int64_t)get_lineage_file_size();
+  file.write((const char*)&nb_flows, sizeof(uint64_t));
+  file.write((const char*)_lineage_start.data(), nb_flows*sizeof(int));
+  file.write((const char*)_lineage_end.data(), nb_flows*sizeof(int));
+  file.write((const char*)_lineage_iteration.data(), nb_flows*sizeof(int));
+  file.write((const char*)_lineage_count.data(), nb_flows*sizeof(double));
+  file.write((const char*)_lineage_geodesic.data(), nb_flows*sizeof(double));
+  file.write((const char*)_lineage_euclidean.data(), nb_flows*sizeof(double));
+  file.write((const char*)&size, sizeof(int64_t));
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 4) Write the walk statistics   */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  file.write((const char*)_walk_histograms.data(), _walk_histograms.size()*sizeof(int64_t));
+  file.close();
+  if (!file || rename(temporary.c_str(), filename.c_str()) != 0)
+  {
+    std::cout << "Error: unable to write checkpoint file " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * \brief    Load a checkpoint of the simulation
+ * \details  The simulation must be built with the parameters, output options, state layout and node order of
+ *           the checkpointed run (the number of iterations and the seed may differ), and on the same map. The
+ *           lineage file is cut to its size at the checkpoint when the next iteration starts.
+ * \param    std::string filename
  * \return   \e void
  */
-void Simulation::write_invasion_euclidean_distributions( std::string observed_filename, std::string simulated_filename )
+void Simulation::load_checkpoint( std::string filename )
 {
-  _graph->write_invasion_euclidean_distributions(observed_filename, simulated_filename);
+  std::ifstream file(filename, std::ios::in | std::ios::binary);
+  if (!file)
+  {
+    std::cout << "Error: unable to open checkpoint file " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Read and check the header   */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  char     magic[8];
+  int32_t  header[7];
+  uint64_t hashes[2];
+  uint64_t expected[2];
+  file.read(magic, 8);
+  file.read((char*)header, sizeof(header));
+  file.read((char*)hashes, sizeof(hashes));
+  compute_checkpoint_hashes(expected);
+  if (!file || strncmp(magic, "MoRISCKP", 8) != 0 || header[0] != (int32_t)CHECKPOINT_VERSION)
+  {
+    std::cout << "Error: " << filename << " is not a MoRIS checkpoint file (or its version is not supported).\n";
+    exit(EXIT_FAILURE);
+  }
+  if (header[2] != (int32_t)_parameters->get_repetitions())
+  {
+    std::cout << "Error: the checkpoint was saved with " << header[2] << " repetitions.\n";
+    exit(EXIT_FAILURE);
+  }
+  if (header[3] != (int32_t)_parameters->saveOutputs() || (header[3] && header[4] != (int32_t)_parameters->get_lineage_mode()))
+  {
+    std::cout << "Error: the checkpoint was saved with other output options (-save-outputs, -lineage).\n";
+    exit(EXIT_FAILURE);
+  }
+  if (header[5] != (int32_t)_parameters->get_state_layout() || header[6] != (int32_t)_parameters->get_node_order())
+  {
+    std::cout << "Error: the checkpoint was saved with another engine configuration (-layout, -order).\n";
+    exit(EXIT_FAILURE);
+  }
+  if (hashes[0] != expected[0])
+  {
+    std::cout << "Error: the checkpoint was saved with other model parameters.\n";
+    exit(EXIT_FAILURE);
+  }
+  if (hashes[1] != expected[1])
+  {
+    std::cout << "Error: the checkpoint does not match the map (other cells, or cells in another order).\n";
+    exit(EXIT_FAILURE);
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Read the simulation state   */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  _prng->read_state(file);
+  _graph->read_checkpoint(file);
+  _iteration = (int)header[1];
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Read the lineage state      */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  initialize_lineage();
+  uint64_t nb_flows = 0;
+  int64_t  size     = 0;
+  file.read((char*)&nb_flows, sizeof(uint64_t));
+  _lineage_start.resize((size_t)nb_flows);
+  _lineage_end.resize((size_t)nb_flows);
+  _lineage_iteration.resize((size_t)nb_flows);
+  _lineage_count.resize((size_t)nb_flows);
+  _lineage_geodesic.resize((size_t)nb_flows);
+  _lineage_euclidean.resize((size_t)nb_flows);
+  file.read((char*)_lineage_start.data(), nb_flows*sizeof(int));
+  file.read((char*)_lineage_end.data(), nb_flows*sizeof(int));
+  file.read((char*)_lineage_iteration.data(), nb_flows*sizeof(int));
+  file.read((char*)_lineage_count.data(), nb_flows*sizeof(double));
+  file.read((char*)_lineage_geodesic.data(), nb_flows*sizeof(double));
+  file.read((char*)_lineage_euclidean.data(), nb_flows*sizeof(double));
+  file.read((char*)&size, sizeof(int64_t));
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 4) Read the walk statistics    */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  file.read((char*)_walk_histograms.data(), _walk_histograms.size()*sizeof(int64_t));
+  if (!file)
+  {
+    std::cout << "Error: checkpoint file " << filename << " is truncated.\n";
+    exit(EXIT_FAILURE);
+  }
+  _lineage_size = (long)size;
+  file.close();
+}
+
+/**
+ * \brief    Write the aggregated lineage tree
+ * \details  Only available with the LINEAGE_AGGREGATED mode. Each line gives a (start node, end node, iteration)
+ *           flow, with its number of jumps (all repetitions) and their mean geodesic and euclidean distances.
+ * \param    std::string filename
+ * \return   \e void
+ */
+void Simulation::write_lineage_flows( std::string filename )
+{
+  assert(_parameters->get_lineage_mode() == LINEAGE_AGGREGATED);
+  std::vector<size_t> order(_lineage_start.size());
+  for (size_t i = 0; i < order.size(); i++)
+  {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [this]( size_t a, size_t b )
+  {
+    if (_lineage_iteration[a] != _lineage_iteration[b])
+    {
+      return _lineage_iteration[a] < _lineage_iteration[b];
+    }
+    if (_lineage_start[a] != _lineage_start[b])
+    {
+      return _lineage_start[a] < _lineage_start[b];
+    }
+    return _lineage_end[a] < _lineage_end[b];
+  });
+  TextWriter file(filename);
+  file << "start_node end_node iteration count mean_geodesic_dist mean_euclidean_dist\n";
+  for (size_t i = 0; i < order.size(); i++)
+  {
+    size_t row = order[i];
+    file << _lineage_start[row] << ' ' << _lineage_end[row] << ' ' << _lineage_iteration[row] << ' ' << _lineage_count[row] << ' ' << _lineage_geodesic[row]/_lineage_count[row] << ' ' << _lineage_euclidean[row]/_lineage_count[row] << '\n';
+  }
+  file.close();
+}
+
+/**
+ * \brief    Write the walk statistics
+ * \details  Only recorded when outputs are saved. Each line gives a distance bin (in cells, the last bin gathers
+ *           the longer distances) and, for all the repetitions, the number of jumps drawn at this distance, the
+ *           number of walks that realized this distance, and the number of walks of this number of steps. The
+ *           last three columns split the jumps drawn at this distance by outcome: walks completed, walks that
+ *           left the map (Node::jump() returned NULL), and walks trapped in a dead end (Node::jump() returned
+ *           the current node, all its neighbors being tagged). A trapped walk is recorded with the distance and
+ *           the number of steps reached at its first dead end. Negative draws of the normal law count as zero.
+ *           Trailing empty bins are not written.
+ * \param    std::string filename
+ * \return   \e void
+ */
+void Simulation::write_walk_statistics( std::string filename )
+{
+  const char* laws[4] = {"DIRAC", "NORMAL", "LOG_NORMAL", "CAUCHY"};
+  const char* law     = laws[_parameters->get_jump_law()];
+  int         nb_bins = 0;
+  for (int bin = 0; bin < WALK_HISTOGRAM_BINS; bin++)
+  {
+    for (int i = 0; i < 6; i++)
+    {
+      if (_walk_histograms[6*bin+i] > 0)
+      {
+        nb_bins = bin+1;
+      }
+    }
+  }
+  TextWriter file(filename);
+  file << "law distance nb_drawn nb_realized nb_steps nb_completed nb_left_map nb_trapped\n";
+  for (int bin = 0; bin < nb_bins; bin++)
+  {
+    const int64_t* row = &_walk_histograms[6*bin];
+    file << law << ' ' << bin << ' ' << (long)row[0] << ' ' << (long)row[1] << ' ' << (long)row[2] << ' ' << (long)row[3] << ' ' << (long)row[4] << ' ' << (long)row[5] << '\n';
+  }
+  file.close();
 }
 
 /*----------------------------
@@ -278,3 +648,187 @@ double Simulation::compute_euclidean_distance( Node* node1, Node* node2 )
   return sqrt((x2-x1)*(x2-x1) + (y2-y1)*(y2-y1));
 }
 
+/**
+ * \brief    Initialize the lineage tree
+ * \details  Closes the lineage tree file (LINEAGE_EVENTS) or the binary lineage writer (LINEAGE_BINARY), which
+ *           are opened again by the next iteration (see open_lineage()). Aggregated flows are cleared.
+ * \param    void
+ * \return   \e void
+ */
+void Simulation::initialize_lineage( void )
+{
+  if (_tree_file.is_open())
+  {
+    _tree_file.close();
+  }
+  delete _lineage_writer;
+  _lineage_writer = NULL;
+  _lineage_file   = "";
+  _lineage_size   = 0;
+  if (_parameters->saveOutputs() && _parameters->get_lineage_mode() == LINEAGE_EVENTS)
+  {
+    _lineage_file = "output/lineage_tree.txt";
+  }
+  else if (_parameters->saveOutputs() && _parameters->get_lineage_mode() == LINEAGE_BINARY)
+  {
+    _lineage_file = "output/lineage_events.bin";
+  }
+  _lineage_index.clear();
+  _lineage_start.clear();
+  _lineage_end.clear();
+  _lineage_iteration.clear();
+  _lineage_count.clear();
+  _lineage_geodesic.clear();
+  _lineage_euclidean.clear();
+}
+
+/**
+ * \brief    Add a jump to the aggregated lineage tree
+ * \details  Flows are indexed by (start node, end node) within the current iteration
+ * \param    Node* start_node
+ * \param    Node* end_node
+ * \param    double geodesic_dist
+ * \param    double euclidean_dist
+ * \return   \e void
+ */
+void Simulation::add_lineage_flow( Node* start_node, Node* end_node, double geodesic_dist, double euclidean_dist )
+{
+  uint64_t key = ((uint64_t)(uint32_t)start_node->get_identifier() << 32) | (uint64_t)(uint32_t)end_node->get_identifier();
+  std::unordered_map<uint64_t, size_t>::iterator it = _lineage_index.find(key);
+  if (it == _lineage_index.end())
+  {
+    _lineage_index[key] = _lineage_start.size();
+    _lineage_start.push_back(start_node->get_identifier());
+    _lineage_end.push_back(end_node->get_identifier());
+    _lineage_iteration.push_back(_iteration);
+    _lineage_count.push_back(1.0);
+    _lineage_geodesic.push_back(geodesic_dist);
+    _lineage_euclidean.push_back(euclidean_dist);
+  }
+  else
+  {
+    _lineage_count[it->second]     += 1.0;
+    _lineage_geodesic[it->second]  += geodesic_dist;
+    _lineage_euclidean[it->second] += euclidean_dist;
+  }
+}
+
+/**
+ * \brief    Add a walk to the walk statistics
+ * \details  Distances and numbers of steps beyond the last bin are counted in the last bin
+ * \param    double drawn_dist
+ * \param    double realized_dist
+ * \param    size_t nb_steps
+ * \param    bool left_map
+ * \param    bool trapped
+ * \return   \e void
+ */
+void Simulation::add_walk( double drawn_dist, double realized_dist, size_t nb_steps, bool left_map, bool trapped )
+{
+  const double last  = (double)(WALK_HISTOGRAM_BINS-1);
+  int          drawn = (int)std::min(std::max(drawn_dist, 0.0), last);
+  int          real  = (int)std::min(realized_dist, last);
+  int          steps = (int)std::min((double)nb_steps, last);
+  _walk_histograms[6*drawn]++;
+  _walk_histograms[6*real+1]++;
+  _walk_histograms[6*steps+2]++;
+  _walk_histograms[6*drawn+(left_map ? 4 : (trapped ? 5 : 3))]++;
+}
+
+/**
+ * \brief    Compute the hashes stored in checkpoints
+ * \details  FNV-1a hashes of the model parameters (type of data, repetitions, jump law, optimization function,
+ *           human activity index, introduction and dispersal parameters, road weights) and of the node
+ *           identifiers, in the order of the simulation loop. The number of iterations and the seed are not
+ *           hashed: a resumed run may be extended, and the Prng state is restored from the checkpoint.
+ * \param    uint64_t* hashes
+ * \return   \e void
+ */
+void Simulation::compute_checkpoint_hashes( uint64_t* hashes )
+{
+  double values[19] = {(double)_parameters->get_typeofdata(), (double)_parameters->get_repetitions(), (double)_parameters->get_jump_law(), (double)_parameters->get_optimization_function(), (double)_parameters->get_human_activity_index(), _parameters->get_x_introduction(), _parameters->get_y_introduction(), _parameters->get_p_introduction(), _parameters->get_lambda(), _parameters->get_mu(), _parameters->get_sigma(), _parameters->get_gamma(), _parameters->get_w1(), _parameters->get_w2(), _parameters->get_w3(), _parameters->get_w4(), _parameters->get_w5(), _parameters->get_w6(), _parameters->get_wmin()};
+  hashes[0] = 14695981039346656037ULL;
+  hashes[1] = 14695981039346656037ULL;
+  const unsigned char* bytes = (const unsigned char*)values;
+  for (size_t i = 0; i < sizeof(values); i++)
+  {
+    hashes[0] = (hashes[0]^bytes[i])*1099511628211ULL;
+  }
+  Node* node = _graph->get_first();
+  while (node != NULL)
+  {
+    int32_t identifier = (int32_t)node->get_identifier();
+    bytes = (const unsigned char*)&identifier;
+    for (size_t i = 0; i < sizeof(int32_t); i++)
+    {
+      hashes[1] = (hashes[1]^bytes[i])*1099511628211ULL;
+    }
+    node = _graph->get_next();
+  }
+}
+
+/**
+ * \brief    Open the lineage tree file or the binary lineage writer if needed
+ * \details  The file is created, or, when resuming from a checkpoint, cut to its size at the checkpoint and
+ *           opened at its end, so that events written after the checkpoint are not duplicated
+ * \param    void
+ * \return   \e void
+ */
+void Simulation::open_lineage( void )
+{
+  if (_lineage_file == "" || _tree_file.is_open() || _lineage_writer != NULL)
+  {
+    return;
+  }
+  if (_lineage_size > 0)
+  {
+    struct stat info;
+    if (stat(_lineage_file.c_str(), &info) != 0 || (long)info.st_size < _lineage_size || truncate(_lineage_file.c_str(), (off_t)_lineage_size) != 0)
+    {
+      std::cout << "Error: unable to resume the lineage file " << _lineage_file << " (missing or shorter than at the checkpoint).\n";
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (_parameters->get_lineage_mode() == LINEAGE_EVENTS && _lineage_size > 0)
+  {
+    _tree_file.append(_lineage_file);
+  }
+  else if (_parameters->get_lineage_mode() == LINEAGE_EVENTS)
+  {
+    _tree_file.open(_lineage_file);
+    _tree_file << "repetition start_node end_node geodesic_dist euclidean_dist iteration\n";
+  }
+  else if (_parameters->get_lineage_mode() == LINEAGE_BINARY)
+  {
+    _lineage_writer = new LineageWriter(_lineage_file, (_lineage_size > 0));
+  }
+}
+
+/**
+ * \brief    Get the size of the lineage file, with all the events written so far
+ * \details  If the file is not open yet, returns the size to resume from (0 for a new file)
+ * \param    void
+ * \return   \e long
+ */
+long Simulation::get_lineage_file_size( void )
+{
+  if (_tree_file.is_open())
+  {
+    _tree_file.flush();
+  }
+  else if (_lineage_writer != NULL)
+  {
+    _lineage_writer->flush();
+  }
+  else
+  {
+    return _lineage_size;
+  }
+  struct stat info;
+  if (stat(_lineage_file.c_str(), &info) != 0)
+  {
+    std::cout << "Error: unable to read the size of the lineage file " << _lineage_file << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  return (long)info.st_size;
+}
@@ -30,11 +30,18 @@
 #define __MoRIS__Simulation__
 
 #include <iostream>
+#include <fstream>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
 #include <cmath>
 #include <cstring>
+#include <cstdio>
 #include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include <assert.h>
 
 #include "Enums.h"
@@ -42,6 +49,10 @@
 #include "Parameters.h"
 #include "Node.h"
 #include "Graph.h"
+#include "LineageWriter.h"
+#include "TextWriter.h"
+#include "Instrumentation.h"
+#include "Tracer.h"
 
 
 class Simulation
@@ -65,6 +76,10 @@ public:
    * GETTERS
    *----------------------------*/
   inline int    get_iteration( void ) const;
+  inline int    get_number_of_nodes( void ) const;
+  inline int    get_number_of_edges( void ) const;
+  inline long   get_number_of_jumps( void ) const;
+  inline long   get_number_of_walk_steps( void ) const;
   inline double get_total_log_likelihood( void ) const;
   inline double get_total_log_empty_likelihood( void ) const;
   inline double get_total_log_maximum_likelihood( void ) const;
@@ -79,32 +94,75 @@ public:
   /*----------------------------
    * PUBLIC METHODS
    *----------------------------*/
+  void reinitialize( void );
   void compute_next_iteration( void );
+  void compute_jumps( void );
+  void update_state( void );
   void compute_score( void );
   void write_state( std::string filename );
-  void write_invasion_euclidean_distributions( std::string observed_filename, std::string simulated_filename );
+  void capture_state( std::vector<int>& identifiers, std::vector<double>& values );
+  void write_invasion_euclidean_distributions( std::string observed_filename, std::string simulated_filename, int nb_bins );
+  void write_lineage_flows( std::string filename );
+  void write_walk_statistics( std::string filename );
+  void write_invasion_time_series( std::string filename );
+  void save_checkpoint( std::string filename );
+  void load_checkpoint( std::string filename );
   
   /*----------------------------
    * PUBLIC ATTRIBUTES
    *----------------------------*/
+  static const int CHECKPOINT_VERSION  = 3;    /*!< Binary checkpoint format version                       */
+  static const int WALK_HISTOGRAM_BINS = 1000; /*!< Unit bins of the walk histograms (the last one is open) */
   
 protected:
   
   /*----------------------------
    * PROTECTED METHODS
    *----------------------------*/
+  template <state_layout LAYOUT> void run_jumps( void );
   int    draw_number_of_jumps( double human_activity_index );
   double draw_jump_size( void );
   double compute_euclidean_distance( Node* node1, Node* node2 );
+  void   initialize_lineage( void );
+  void   open_lineage( void );
+  long   get_lineage_file_size( void );
+  void   add_lineage_flow( Node* start_node, Node* end_node, double geodesic_dist, double euclidean_dist );
+  void   add_walk( double drawn_dist, double realized_dist, size_t nb_steps, bool left_map, bool trapped );
+  void   compute_checkpoint_hashes( uint64_t* hashes );
   
   /*----------------------------
    * PROTECTED ATTRIBUTES
    *----------------------------*/
   
-  Parameters* _parameters; /*!< Main parameters   */
-  Prng*       _prng;       /*!< Prng              */
-  Graph*      _graph;      /*!< Graph structure   */
-  int         _iteration;  /*!< Current iteration */
+  /*--------------------------------------- MAIN STRUCTURES */
+  
+  Parameters* _parameters;    /*!< Main parameters                                    */
+  Prng*       _prng;          /*!< Prng                                               */
+  Graph*      _graph;         /*!< Graph structure                                    */
+  int         _iteration;     /*!< Current iteration                                  */
+  long        _nb_jumps;      /*!< Number of jumps drawn since the (re)initialization */
+  long        _nb_walk_steps; /*!< Number of walk steps since the (re)initialization  */
+  
+  /*--------------------------------------- LINEAGE TREE */
+  
+  TextWriter     _tree_file;      /*!< Lineage tree file (LINEAGE_EVENTS)                         */
+  LineageWriter* _lineage_writer; /*!< Binary lineage writer (LINEAGE_BINARY)                    */
+  std::string    _lineage_file;   /*!< Lineage file name (empty if not saved)                    */
+  long           _lineage_size;   /*!< Lineage file size to resume from (0 to create a new file) */
+  
+  /*--------------------------------------- AGGREGATED LINEAGE */
+  
+  std::unordered_map<uint64_t, size_t> _lineage_index;     /*!< Flow row of each (start, end) pair in the current iteration */
+  std::vector<int>                     _lineage_start;     /*!< Start node of each flow                                     */
+  std::vector<int>                     _lineage_end;       /*!< End node of each flow                                       */
+  std::vector<int>                     _lineage_iteration; /*!< Iteration of each flow                                      */
+  std::vector<double>                  _lineage_count;     /*!< Number of jumps of each flow                                */
+  std::vector<double>                  _lineage_geodesic;  /*!< Sum of the geodesic distances of each flow                  */
+  std::vector<double>                  _lineage_euclidean; /*!< Sum of the euclidean distances of each flow                 */
+  
+  /*--------------------------------------- WALK STATISTICS */
+  
+  std::vector<int64_t> _walk_histograms; /*!< Walk histograms, by distance bin (see write_walk_statistics()) */
   
 };
 
@@ -124,6 +182,50 @@ inline int Simulation::get_iteration( void ) const
   return _iteration;
 }
 
+/**
+ * \brief    Get the number of nodes of the graph
+ * \details  --
+ * \param    void
+ * \return   \e int
+ */
+inline int Simulation::get_number_of_nodes( void ) const
+{
+  return _graph->get_number_of_nodes();
+}
+
+/**
+ * \brief    Get the number of edges of the graph
+ * \details  --
+ * \param    void
+ * \return   \e int
+ */
+inline int Simulation::get_number_of_edges( void ) const
+{
+  return _graph->get_number_of_edges();
+}
+
+/**
+ * \brief    Get the number of jumps drawn since the (re)initialization
+ * \details  --
+ * \param    void
+ * \return   \e long
+ */
+inline long Simulation::get_number_of_jumps( void ) const
+{
+  return _nb_jumps;
+}
+
+/**
+ * \brief    Get the number of walk steps since the (re)initialization
+ * \details  --
+ * \param    void
+ * \return   \e long
+ */
+inline long Simulation::get_number_of_walk_steps( void ) const
+{
+  return _nb_walk_steps;
+}
+
 /**
  * \brief    Get the total log likelihood
  * \details  --
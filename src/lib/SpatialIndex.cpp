@@ -0,0 +1,267 @@
+/**
+ * \file      SpatialIndex.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     SpatialIndex class definition
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "SpatialIndex.h"
+
+
+/*----------------------------
+ * CONSTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Constructor
+ * \details  Nodes are bucketed in a uniform grid holding about one node by cell.
+ *           The order of the nodes vector defines the rank used to break distance ties.
+ * \param    const std::vector<Node*>& nodes
+ * \return   \e void
+ */
+SpatialIndex::SpatialIndex( const std::vector<Node*>& nodes )
+{
+  assert(nodes.size() > 0);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Copy node coordinates                  */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  _nodes = nodes;
+  _x.resize(_nodes.size());
+  _y.resize(_nodes.size());
+  double xmax = -1e+300;
+  double ymax = -1e+300;
+  _xmin       = 1e+300;
+  _ymin       = 1e+300;
+  for (size_t i = 0; i < _nodes.size(); i++)
+  {
+    _x[i] = _nodes[i]->get_x();
+    _y[i] = _nodes[i]->get_y();
+    _xmin = (_x[i] < _xmin ? _x[i] : _xmin);
+    _ymin = (_y[i] < _ymin ? _y[i] : _ymin);
+    xmax  = (_x[i] > xmax ? _x[i] : xmax);
+    ymax  = (_y[i] > ymax ? _y[i] : ymax);
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Define the grid                        */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  double width  = xmax-_xmin;
+  double height = ymax-_ymin;
+  double n      = (double)_nodes.size();
+  if (width > 0.0 && height > 0.0)
+  {
+    _cell_size = sqrt(width*height/n);
+  }
+  else if (width > 0.0 || height > 0.0)
+  {
+    _cell_size = (width > height ? width : height)/n;
+  }
+  else
+  {
+    _cell_size = 1.0;
+  }
+  _nx = (int)floor(width/_cell_size)+1;
+  _ny = (int)floor(height/_cell_size)+1;
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Bucket the nodes (counting sort)       */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<int> cells(_nodes.size(), 0);
+  _cell_start.assign(_nx*_ny+1, 0);
+  for (size_t i = 0; i < _nodes.size(); i++)
+  {
+    cells[i] = get_cell_y(_y[i])*_nx+get_cell_x(_x[i]);
+    _cell_start[cells[i]+1]++;
+  }
+  for (int cell = 0; cell < _nx*_ny; cell++)
+  {
+    _cell_start[cell+1] += _cell_start[cell];
+  }
+  std::vector<int> position(_cell_start.begin(), _cell_start.end()-1);
+  _cell_nodes.assign(_nodes.size(), 0);
+  for (size_t i = 0; i < _nodes.size(); i++)
+  {
+    _cell_nodes[position[cells[i]]] = (int)i;
+    position[cells[i]]++;
+  }
+}
+
+/*----------------------------
+ * DESTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Destructor
+ * \details  Nodes are owned by the graph
+ * \param    void
+ * \return   \e void
+ */
+SpatialIndex::~SpatialIndex( void )
+{
+  _nodes.clear();
+  _x.clear();
+  _y.clear();
+  _cell_start.clear();
+  _cell_nodes.clear();
+}
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Get the nearest node from a point
+ * \details  Grid cells are visited by rings of increasing size around the point, until no unvisited cell
+ *           can hold a closer node. Equally distant nodes are ranked as in a linear scan.
+ * \param    double x
+ * \param    double y
+ * \param    double& distance
+ * \return   \e Node*
+ */
+Node* SpatialIndex::get_nearest( double x, double y, double& distance ) const
+{
+  int    cx            = get_cell_x(x);
+  int    cy            = get_cell_y(y);
+  int    max_ring      = (_nx > _ny ? _nx : _ny);
+  double best_distance = 1e+300;
+  int    best          = -1;
+  for (int ring = 0; ring <= max_ring; ring++)
+  {
+    /*** Nodes beyond this ring are at least (ring-1)*cell_size away ***/
+    if (best != -1 && best_distance < (double)(ring-1)*_cell_size)
+    {
+      break;
+    }
+    int xmin = cx-ring;
+    int xmax = cx+ring;
+    int ymin = cy-ring;
+    int ymax = cy+ring;
+    for (int i = (xmin < 0 ? 0 : xmin); i <= (xmax >= _nx ? _nx-1 : xmax); i++)
+    {
+      if (ymin >= 0)
+      {
+        visit_cell(i, ymin, x, y, best_distance, best);
+      }
+      if (ring > 0 && ymax < _ny)
+      {
+        visit_cell(i, ymax, x, y, best_distance, best);
+      }
+    }
+    for (int j = (ymin+1 < 0 ? 0 : ymin+1); j <= (ymax-1 >= _ny ? _ny-1 : ymax-1); j++)
+    {
+      if (xmin >= 0)
+      {
+        visit_cell(xmin, j, x, y, best_distance, best);
+      }
+      if (ring > 0 && xmax < _nx)
+      {
+        visit_cell(xmax, j, x, y, best_distance, best);
+      }
+    }
+  }
+  assert(best != -1);
+  distance = best_distance;
+  return _nodes[best];
+}
+
+/**
+ * \brief    Get the nodes at a distance lower or equal to radius from a point
+ * \details  Nodes are returned by rank
+ * \param    double x
+ * \param    double y
+ * \param    double radius
+ * \param    std::vector<Node*>& nodes
+ * \return   \e void
+ */
+void SpatialIndex::get_in_radius( double x, double y, double radius, std::vector<Node*>& nodes ) const
+{
+  assert(radius >= 0.0);
+  nodes.clear();
+  std::vector<int> ranks;
+  int              cx_min = get_cell_x(x-radius);
+  int              cx_max = get_cell_x(x+radius);
+  int              cy_min = get_cell_y(y-radius);
+  int              cy_max = get_cell_y(y+radius);
+  for (int j = cy_min; j <= cy_max; j++)
+  {
+    for (int i = cx_min; i <= cx_max; i++)
+    {
+      int cell = j*_nx+i;
+      for (int k = _cell_start[cell]; k < _cell_start[cell+1]; k++)
+      {
+        int rank = _cell_nodes[k];
+        if (sqrt((x-_x[rank])*(x-_x[rank]) + (y-_y[rank])*(y-_y[rank])) <= radius)
+        {
+          ranks.push_back(rank);
+        }
+      }
+    }
+  }
+  std::sort(ranks.begin(), ranks.end());
+  for (size_t i = 0; i < ranks.size(); i++)
+  {
+    nodes.push_back(_nodes[ranks[i]]);
+  }
+}
+
+/**
+ * \brief    Get the nodes inside a rectangular box (bounds included)
+ * \details  Nodes are returned by rank
+ * \param    double xmin
+ * \param    double xmax
+ * \param    double ymin
+ * \param    double ymax
+ * \param    std::vector<Node*>& nodes
+ * \return   \e void
+ */
+void SpatialIndex::get_in_box( double xmin, double xmax, double ymin, double ymax, std::vector<Node*>& nodes ) const
+{
+  nodes.clear();
+  if (xmin > xmax || ymin > ymax)
+  {
+    return;
+  }
+  std::vector<int> ranks;
+  for (int j = get_cell_y(ymin); j <= get_cell_y(ymax); j++)
+  {
+    for (int i = get_cell_x(xmin); i <= get_cell_x(xmax); i++)
+    {
+      int cell = j*_nx+i;
+      for (int k = _cell_start[cell]; k < _cell_start[cell+1]; k++)
+      {
+        int rank = _cell_nodes[k];
+        if (_x[rank] >= xmin && _x[rank] <= xmax && _y[rank] >= ymin && _y[rank] <= ymax)
+        {
+          ranks.push_back(rank);
+        }
+      }
+    }
+  }
+  std::sort(ranks.begin(), ranks.end());
+  for (size_t i = 0; i < ranks.size(); i++)
+  {
+    nodes.push_back(_nodes[ranks[i]]);
+  }
+}
@@ -0,0 +1,187 @@
+/**
+ * \file      SpatialIndex.h
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     SpatialIndex class declaration
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef __MoRIS__SpatialIndex__
+#define __MoRIS__SpatialIndex__
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "Node.h"
+
+
+class SpatialIndex
+{
+  
+public:
+  
+  /*----------------------------
+   * CONSTRUCTORS
+   *----------------------------*/
+  SpatialIndex( void ) = delete;
+  SpatialIndex( const std::vector<Node*>& nodes );
+  SpatialIndex( const SpatialIndex& index ) = delete;
+  
+  /*----------------------------
+   * DESTRUCTORS
+   *----------------------------*/
+  ~SpatialIndex( void );
+  
+  /*----------------------------
+   * GETTERS
+   *----------------------------*/
+  inline int get_number_of_nodes( void ) const;
+  
+  /*----------------------------
+   * SETTERS
+   *----------------------------*/
+  SpatialIndex& operator=(const SpatialIndex&) = delete;
+  
+  /*----------------------------
+   * PUBLIC METHODS
+   *----------------------------*/
+  Node* get_nearest( double x, double y, double& distance ) const;
+  void  get_in_radius( double x, double y, double radius, std::vector<Node*>& nodes ) const;
+  void  get_in_box( double xmin, double xmax, double ymin, double ymax, std::vector<Node*>& nodes ) const;
+  
+  /*----------------------------
+   * PUBLIC ATTRIBUTES
+   *----------------------------*/
+  
+protected:
+  
+  /*----------------------------
+   * PROTECTED METHODS
+   *----------------------------*/
+  inline int  get_cell_x( double x ) const;
+  inline int  get_cell_y( double y ) const;
+  inline void visit_cell( int cx, int cy, double x, double y, double& best_distance, int& best ) const;
+  
+  /*----------------------------
+   * PROTECTED ATTRIBUTES
+   *----------------------------*/
+  
+  /*--------------------------------------- INDEXED NODES */
+  
+  std::vector<Node*>  _nodes; /*!< Indexed nodes, by rank (graph iteration order) */
+  std::vector<double> _x;     /*!< Node x coordinates, by rank                    */
+  std::vector<double> _y;     /*!< Node y coordinates, by rank                    */
+  
+  /*--------------------------------------- UNIFORM GRID */
+  
+  double           _xmin;       /*!< Grid origin (x)                                  */
+  double           _ymin;       /*!< Grid origin (y)                                  */
+  double           _cell_size;  /*!< Size of a grid cell                              */
+  int              _nx;         /*!< Number of grid cells along x                     */
+  int              _ny;         /*!< Number of grid cells along y                     */
+  std::vector<int> _cell_start; /*!< First entry of each grid cell in _cell_nodes    */
+  std::vector<int> _cell_nodes; /*!< Node ranks sorted by grid cell, then by rank    */
+  
+};
+
+
+/*----------------------------
+ * GETTERS
+ *----------------------------*/
+
+/**
+ * \brief    Get the number of indexed nodes
+ * \details  --
+ * \param    void
+ * \return   \e int
+ */
+inline int SpatialIndex::get_number_of_nodes( void ) const
+{
+  return (int)_nodes.size();
+}
+
+/*----------------------------
+ * SETTERS
+ *----------------------------*/
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Get the grid column of a x coordinate (clamped to the grid)
+ * \details  --
+ * \param    double x
+ * \return   \e int
+ */
+inline int SpatialIndex::get_cell_x( double x ) const
+{
+  double cx = floor((x-_xmin)/_cell_size);
+  return (cx < 0.0 ? 0 : (cx >= (double)_nx ? _nx-1 : (int)cx));
+}
+
+/**
+ * \brief    Get the grid row of a y coordinate (clamped to the grid)
+ * \details  --
+ * \param    double y
+ * \return   \e int
+ */
+inline int SpatialIndex::get_cell_y( double y ) const
+{
+  double cy = floor((y-_ymin)/_cell_size);
+  return (cy < 0.0 ? 0 : (cy >= (double)_ny ? _ny-1 : (int)cy));
+}
+
+/**
+ * \brief    Update the nearest node with the nodes of a grid cell
+ * \details  Ties are broken by rank, as a linear scan in graph iteration order would do
+ * \param    int cx
+ * \param    int cy
+ * \param    double x
+ * \param    double y
+ * \param    double& best_distance
+ * \param    int& best
+ * \return   \e void
+ */
+inline void SpatialIndex::visit_cell( int cx, int cy, double x, double y, double& best_distance, int& best ) const
+{
+  int cell = cy*_nx+cx;
+  for (int i = _cell_start[cell]; i < _cell_start[cell+1]; i++)
+  {
+    int    rank = _cell_nodes[i];
+    double dist = sqrt((x-_x[rank])*(x-_x[rank]) + (y-_y[rank])*(y-_y[rank]));
+    if (dist < best_distance || (dist == best_distance && rank < best))
+    {
+      best_distance = dist;
+      best          = rank;
+    }
+  }
+}
+
+
+#endif /* defined(__MoRIS__SpatialIndex__) */
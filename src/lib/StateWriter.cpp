@@ -0,0 +1,374 @@
+/**
+ * \file      StateWriter.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     StateWriter class definition
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "StateWriter.h"
+
+
+/*----------------------------
+ * CONSTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Constructor
+ * \details  With TEXT_STATES, each state is written in <path><iteration>.txt. With BINARY_HISTORY, all the
+ *           states are written in the binary file <path>. Starts the writer thread.
+ * \param    state_output_format format
+ * \param    std::string path
+ * \return   \e void
+ */
+StateWriter::StateWriter( state_output_format format, std::string path )
+{
+  /*--------------------------------------- OUTPUT */
+  
+  _format = format;
+  _path   = path;
+  _last.clear();
+  _record.clear();
+  if (_format == BINARY_HISTORY)
+  {
+    _history.open(_path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!_history)
+    {
+      std::cout << "Error: unable to open state history file " << _path << ".\n";
+      exit(EXIT_FAILURE);
+    }
+  }
+  
+  /*--------------------------------------- DOUBLE BUFFER */
+  
+  for (int i = 0; i < 2; i++)
+  {
+    _identifiers[i].clear();
+    _values[i].clear();
+    _iterations[i] = 0;
+    _pending[i]    = false;
+  }
+  _next_capture = 0;
+  _next_write   = 0;
+  
+  /*--------------------------------------- WRITER THREAD */
+  
+  _stop   = false;
+  _thread = std::thread(&StateWriter::run, this);
+}
+
+/*----------------------------
+ * DESTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Destructor
+ * \details  Pending states are written before the writer thread terminates
+ * \param    void
+ * \return   \e void
+ */
+StateWriter::~StateWriter( void )
+{
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _condition.notify_all();
+  _thread.join();
+  if (_format == BINARY_HISTORY)
+  {
+    _history.close();
+  }
+  _last.clear();
+  _record.clear();
+  for (int i = 0; i < 2; i++)
+  {
+    _identifiers[i].clear();
+    _values[i].clear();
+  }
+}
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Capture the simulation state and hand it to the writer thread
+ * \details  Only waits if both buffers are still pending, so that writing the previous state
+ *           overlaps with the next iteration
+ * \param    Simulation* simulation
+ * \return   \e void
+ */
+void StateWriter::capture( Simulation* simulation )
+{
+  int buffer = 0;
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this]{ return !_pending[_next_capture]; });
+    buffer        = _next_capture;
+    _next_capture = 1-_next_capture;
+  }
+  simulation->capture_state(_identifiers[buffer], _values[buffer]);
+  _iterations[buffer] = simulation->get_iteration();
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _pending[buffer] = true;
+  }
+  _condition.notify_all();
+}
+
+/**
+ * \brief    Wait until all the captured states are written
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void StateWriter::flush( void )
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _condition.wait(lock, [this]{ return !_pending[0] && !_pending[1]; });
+}
+
+/**
+ * \brief    Get the list of iterations saved in a binary history file
+ * \details  --
+ * \param    std::string filename
+ * \param    std::vector<int>& iterations
+ * \return   \e void
+ */
+void StateWriter::get_history_iterations( std::string filename, std::vector<int>& iterations )
+{
+  std::ifstream    file;
+  std::vector<int> identifiers;
+  open_history(file, filename, identifiers);
+  iterations.clear();
+  int32_t  iteration  = 0;
+  uint32_t nb_changed = 0;
+  size_t   node_bytes = sizeof(uint32_t)+(Graph::STATE_VALUES-HISTORY_GLOBAL_VALUES)*sizeof(double);
+  while (file.read((char*)&iteration, sizeof(int32_t)))
+  {
+    file.seekg(HISTORY_GLOBAL_VALUES*sizeof(double), std::ios::cur);
+    if (!file.read((char*)&nb_changed, sizeof(uint32_t)))
+    {
+      break;
+    }
+    file.seekg(nb_changed*node_bytes, std::ios::cur);
+    if (!file)
+    {
+      break;
+    }
+    iterations.push_back(iteration);
+  }
+  file.close();
+}
+
+/**
+ * \brief    Reconstruct the state of a given iteration from a binary history file
+ * \details  Records are replayed up to the iteration. Values are returned in the capture layout
+ *           (see Graph::capture_state), so the state can be written with Graph::write_captured_state.
+ *           Returns false if the iteration is not in the file.
+ * \param    std::string filename
+ * \param    int iteration
+ * \param    std::vector<int>& identifiers
+ * \param    std::vector<double>& values
+ * \return   \e bool
+ */
+bool StateWriter::read_history( std::string filename, int iteration, std::vector<int>& identifiers, std::vector<double>& values )
+{
+  std::ifstream file;
+  open_history(file, filename, identifiers);
+  int nb_node_values = Graph::STATE_VALUES-HISTORY_GLOBAL_VALUES;
+  values.assign(identifiers.size()*Graph::STATE_VALUES, 0.0);
+  int32_t  record_iteration = 0;
+  double   global_values[HISTORY_GLOBAL_VALUES];
+  uint32_t nb_changed       = 0;
+  uint32_t index            = 0;
+  while (file.read((char*)&record_iteration, sizeof(int32_t)) && record_iteration <= iteration)
+  {
+    file.read((char*)global_values, HISTORY_GLOBAL_VALUES*sizeof(double));
+    file.read((char*)&nb_changed, sizeof(uint32_t));
+    for (uint32_t i = 0; i < nb_changed && file; i++)
+    {
+      file.read((char*)&index, sizeof(uint32_t));
+      if (index >= identifiers.size())
+      {
+        std::cout << "Error: corrupted state history file " << filename << ".\n";
+        exit(EXIT_FAILURE);
+      }
+      file.read((char*)&values[(size_t)index*Graph::STATE_VALUES], nb_node_values*sizeof(double));
+    }
+    if (!file)
+    {
+      break;
+    }
+    for (size_t node = 0; node < identifiers.size(); node++)
+    {
+      memcpy(&values[node*Graph::STATE_VALUES+nb_node_values], global_values, HISTORY_GLOBAL_VALUES*sizeof(double));
+    }
+    if (record_iteration == iteration)
+    {
+      file.close();
+      return true;
+    }
+  }
+  file.close();
+  return false;
+}
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Writer thread loop
+ * \details  Writes the buffers in capture order
+ * \param    void
+ * \return   \e void
+ */
+void StateWriter::run( void )
+{
+  while (true)
+  {
+    int buffer = 0;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this]{ return _pending[_next_write] || _stop; });
+      if (!_pending[_next_write])
+      {
+        return;
+      }
+      buffer = _next_write;
+    }
+    MORIS_TRACE_BEGIN("state_write");
+    if (_format == TEXT_STATES)
+    {
+      std::stringstream filename;
+      filename << _path << _iterations[buffer] << ".txt";
+      Graph::write_captured_state(filename.str(), _identifiers[buffer], _values[buffer]);
+    }
+    else
+    {
+      write_history_record(buffer);
+    }
+    MORIS_TRACE_END("state_write", "iteration", _iterations[buffer]);
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _pending[buffer] = false;
+      _next_write      = 1-_next_write;
+    }
+    _condition.notify_all();
+  }
+}
+
+/**
+ * \brief    Append a state to the binary history file
+ * \details  The file starts with the header "MoRISHST", the format version, the number of nodes, the number
+ *           of values by node and the node identifiers. Each record then contains the iteration, the values
+ *           shared by all the nodes (scores), the number of changed nodes, and the index and values of each
+ *           node whose values changed since the previous record (all the nodes in the first record).
+ *           Numbers are written in native byte order.
+ * \param    int buffer
+ * \return   \e void
+ */
+void StateWriter::write_history_record( int buffer )
+{
+  const std::vector<int>&    identifiers    = _identifiers[buffer];
+  const std::vector<double>& values         = _values[buffer];
+  int                        nb_node_values = Graph::STATE_VALUES-HISTORY_GLOBAL_VALUES;
+  size_t                     node_bytes     = nb_node_values*sizeof(double);
+  _record.clear();
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Write the header with the first state */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  bool first = (_last.size() == 0);
+  if (first)
+  {
+    uint32_t header[3] = {(uint32_t)HISTORY_VERSION, (uint32_t)identifiers.size(), (uint32_t)nb_node_values};
+    _record.insert(_record.end(), "MoRISHST", "MoRISHST"+8);
+    _record.insert(_record.end(), (const char*)header, (const char*)header+sizeof(header));
+    for (size_t i = 0; i < identifiers.size(); i++)
+    {
+      int32_t identifier = identifiers[i];
+      _record.insert(_record.end(), (const char*)&identifier, (const char*)&identifier+sizeof(int32_t));
+    }
+    _last.assign(values.size(), 0.0);
+  }
+  assert(_last.size() == values.size());
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Write the changed nodes               */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  int32_t iteration = _iterations[buffer];
+  _record.insert(_record.end(), (const char*)&iteration, (const char*)&iteration+sizeof(int32_t));
+  const char* global_values = (const char*)&values[nb_node_values];
+  _record.insert(_record.end(), global_values, global_values+HISTORY_GLOBAL_VALUES*sizeof(double));
+  size_t   count_position = _record.size();
+  uint32_t nb_changed     = 0;
+  _record.resize(_record.size()+sizeof(uint32_t));
+  for (size_t node = 0; node < identifiers.size(); node++)
+  {
+    const double* node_values = &values[node*Graph::STATE_VALUES];
+    double*       last_values = &_last[node*Graph::STATE_VALUES];
+    if (first || memcmp(node_values, last_values, node_bytes) != 0)
+    {
+      uint32_t index = (uint32_t)node;
+      _record.insert(_record.end(), (const char*)&index, (const char*)&index+sizeof(uint32_t));
+      _record.insert(_record.end(), (const char*)node_values, (const char*)node_values+node_bytes);
+      memcpy(last_values, node_values, node_bytes);
+      nb_changed++;
+    }
+  }
+  memcpy(&_record[count_position], &nb_changed, sizeof(uint32_t));
+  _history.write(_record.data(), _record.size());
+}
+
+/**
+ * \brief    Open a binary history file and read its header
+ * \details  --
+ * \param    std::ifstream& file
+ * \param    std::string filename
+ * \param    std::vector<int>& identifiers
+ * \return   \e void
+ */
+void StateWriter::open_history( std::ifstream& file, std::string filename, std::vector<int>& identifiers )
+{
+  file.open(filename, std::ios::in | std::ios::binary);
+  if (!file)
+  {
+    std::cout << "Error: unable to open state history file " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  char     magic[8];
+  uint32_t header[3];
+  file.read(magic, 8);
+  file.read((char*)header, sizeof(header));
+  if (!file || strncmp(magic, "MoRISHST", 8) != 0 || header[0] != (uint32_t)HISTORY_VERSION || header[2] != (uint32_t)(Graph::STATE_VALUES-HISTORY_GLOBAL_VALUES))
+  {
+    std::cout << "Error: " << filename << " is not a valid state history file.\n";
+    exit(EXIT_FAILURE);
+  }
+  std::vector<int32_t> buffer(header[1]);
+  file.read((char*)buffer.data(), header[1]*sizeof(int32_t));
+  identifiers.assign(buffer.begin(), buffer.end());
+}
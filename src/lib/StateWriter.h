@@ -0,0 +1,131 @@
+/**
+ * \file      StateWriter.h
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     StateWriter class declaration
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef __MoRIS__StateWriter__
+#define __MoRIS__StateWriter__
+
+#include <iostream>
+#include <fstream>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "Enums.h"
+#include "Graph.h"
+#include "Simulation.h"
+
+
+class StateWriter
+{
+  
+public:
+  
+  /*----------------------------
+   * CONSTRUCTORS
+   *----------------------------*/
+  StateWriter( void ) = delete;
+  StateWriter( state_output_format format, std::string path );
+  StateWriter( const StateWriter& writer ) = delete;
+  
+  /*----------------------------
+   * DESTRUCTORS
+   *----------------------------*/
+  ~StateWriter( void );
+  
+  /*----------------------------
+   * GETTERS
+   *----------------------------*/
+  
+  /*----------------------------
+   * SETTERS
+   *----------------------------*/
+  StateWriter& operator=(const StateWriter&) = delete;
+  
+  /*----------------------------
+   * PUBLIC METHODS
+   *----------------------------*/
+  void capture( Simulation* simulation );
+  void flush( void );
+  
+  static void get_history_iterations( std::string filename, std::vector<int>& iterations );
+  static bool read_history( std::string filename, int iteration, std::vector<int>& identifiers, std::vector<double>& values );
+  
+  /*----------------------------
+   * PUBLIC ATTRIBUTES
+   *----------------------------*/
+  static const int HISTORY_VERSION       = 3; /*!< Binary history format version                    */
+  static const int HISTORY_GLOBAL_VALUES = 5; /*!< Values shared by all the nodes (scores, last ones) */
+  
+protected:
+  
+  /*----------------------------
+   * PROTECTED METHODS
+   *----------------------------*/
+  void run( void );
+  void write_history_record( int buffer );
+  
+  static void open_history( std::ifstream& file, std::string filename, std::vector<int>& identifiers );
+  
+  /*----------------------------
+   * PROTECTED ATTRIBUTES
+   *----------------------------*/
+  
+  /*--------------------------------------- OUTPUT */
+  
+  state_output_format _format;  /*!< State output format                                     */
+  std::string         _path;    /*!< Filename prefix (text states) or filename (binary history) */
+  std::ofstream       _history; /*!< Binary history file                                     */
+  std::vector<double> _last;    /*!< Last written node values (binary history)               */
+  std::vector<char>   _record;  /*!< Binary history record being built                       */
+  
+  /*--------------------------------------- DOUBLE BUFFER */
+  
+  std::vector<int>    _identifiers[2]; /*!< Node identifiers of each buffer       */
+  std::vector<double> _values[2];      /*!< Node values of each buffer            */
+  int                 _iterations[2];  /*!< Iteration of each buffer              */
+  bool                _pending[2];     /*!< Buffers waiting for (or being) written */
+  int                 _next_capture;   /*!< Next buffer to fill                   */
+  int                 _next_write;     /*!< Next buffer to write                  */
+  
+  /*--------------------------------------- WRITER THREAD */
+  
+  std::thread             _thread;    /*!< Writer thread                        */
+  std::mutex              _mutex;     /*!< Protects the buffer flags            */
+  std::condition_variable _condition; /*!< Signals buffer flag changes          */
+  bool                    _stop;      /*!< Asks the writer thread to terminate  */
+  
+};
+
+
+#endif /* defined(__MoRIS__StateWriter__) */
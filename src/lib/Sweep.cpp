@@ -0,0 +1,660 @@
+/**
+ * \file      Sweep.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     Sweep class definition
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "Sweep.h"
+
+
+/*----------------------------
+ * CONSTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Constructor
+ * \details  Base parameters are given as (name, value) pairs, with MoRIS_run option names
+ * \param    std::vector<std::string> base_names
+ * \param    std::vector<std::string> base_values
+ * \param    int nb_threads
+ * \return   \e void
+ */
+Sweep::Sweep( std::vector<std::string> base_names, std::vector<std::string> base_values, int nb_threads )
+{
+  assert(base_names.size() == base_values.size());
+  assert(nb_threads > 0);
+
+  /*--------------------------------------- BASE PARAMETERS */
+
+  _base_names  = base_names;
+  _base_values = base_values;
+  _nb_threads  = nb_threads;
+
+  /*--------------------------------------- DESIGN */
+
+  _design_names.clear();
+  _design_values.clear();
+  _label_name = "";
+  _labels.clear();
+
+  /*--------------------------------------- EVALUATION */
+
+  _done.clear();
+  _next_set = 0;
+}
+
+/*----------------------------
+ * DESTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Destructor
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+Sweep::~Sweep( void )
+{
+  _base_names.clear();
+  _base_values.clear();
+  _design_names.clear();
+  _design_values.clear();
+  _labels.clear();
+  _done.clear();
+}
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Set the design
+ * \details  --
+ * \param    std::vector<std::string> names
+ * \param    std::vector< std::vector<std::string> > values
+ * \return   \e void
+ */
+void Sweep::set_design( std::vector<std::string> names, std::vector< std::vector<std::string> > values )
+{
+  _design_names.clear();
+  _design_values.clear();
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    add_design_name(names[i]);
+  }
+  for (size_t set = 0; set < values.size(); set++)
+  {
+    assert(values[set].size() == names.size());
+    _design_values.push_back(values[set]);
+  }
+  check_design();
+}
+
+/**
+ * \brief    Set a label column written before the parameter values in the results table
+ * \details  Labels identify the sets (e.g. the candidate cell of an introduction-site scan) and must not contain spaces
+ * \param    std::string name
+ * \param    std::vector<std::string> labels
+ * \return   \e void
+ */
+void Sweep::set_labels( std::string name, std::vector<std::string> labels )
+{
+  assert(labels.size() == _design_values.size());
+  _label_name = name;
+  _labels     = labels;
+}
+
+/**
+ * \brief    Load the design from a CSV file
+ * \details  The first line contains the parameter names (MoRIS_run option names), each following line is a parameter set
+ * \param    std::string filename
+ * \return   \e void
+ */
+void Sweep::load_design( std::string filename )
+{
+  std::ifstream file(filename, std::ios::in);
+  if (!file)
+  {
+    std::cout << "Error: unable to open design file " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  _design_names.clear();
+  _design_values.clear();
+  std::string line;
+  bool        header = true;
+  while(getline(file, line))
+  {
+    std::vector<std::string> fields;
+    std::stringstream        flux(line);
+    std::string              field;
+    while (getline(flux, field, ','))
+    {
+      size_t start = field.find_first_not_of(" \t\r");
+      size_t end   = field.find_last_not_of(" \t\r");
+      fields.push_back(start == std::string::npos ? "" : field.substr(start, end-start+1));
+    }
+    if (fields.size() == 0 || (fields.size() == 1 && fields[0] == ""))
+    {
+      continue;
+    }
+    if (header)
+    {
+      for (size_t i = 0; i < fields.size(); i++)
+      {
+        add_design_name(fields[i]);
+      }
+      header = false;
+    }
+    else if (fields.size() != _design_names.size())
+    {
+      std::cout << "Error: wrong number of values in design line \"" << line << "\".\n";
+      exit(EXIT_FAILURE);
+    }
+    else
+    {
+      _design_values.push_back(fields);
+    }
+  }
+  file.close();
+  check_design();
+}
+
+/**
+ * \brief    Build a full factorial design from a grid specification file
+ * \details  Each line of the specification reads "name min max n" (n regularly spaced values from min to max).
+ *           The last parameter varies fastest.
+ * \param    std::string filename
+ * \return   \e void
+ */
+void Sweep::build_grid_design( std::string filename )
+{
+  std::ifstream file(filename, std::ios::in);
+  if (!file)
+  {
+    std::cout << "Error: unable to open grid specification file " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  _design_names.clear();
+  _design_values.clear();
+  std::vector< std::vector<std::string> > levels;
+  std::string line;
+  while(getline(file, line))
+  {
+    std::stringstream flux(line);
+    std::string       name = "";
+    double            min  = 0.0;
+    double            max  = 0.0;
+    int               n    = 0;
+    if (!(flux >> name) || name[0] == '#')
+    {
+      continue;
+    }
+    if (!(flux >> min >> max >> n) || n < 1)
+    {
+      std::cout << "Error: wrong grid specification line \"" << line << "\".\n";
+      exit(EXIT_FAILURE);
+    }
+    add_design_name(name);
+    std::vector<std::string> values;
+    for (int i = 0; i < n; i++)
+    {
+      values.push_back(format_value(n == 1 ? min : min+(max-min)*(double)i/(double)(n-1)));
+    }
+    levels.push_back(values);
+  }
+  file.close();
+  if (levels.size() == 0)
+  {
+    return;
+  }
+  std::vector<size_t> index(levels.size(), 0);
+  while (true)
+  {
+    std::vector<std::string> set;
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+      set.push_back(levels[i][index[i]]);
+    }
+    _design_values.push_back(set);
+    int dim = (int)levels.size()-1;
+    while (dim >= 0 && ++index[dim] == levels[dim].size())
+    {
+      index[dim] = 0;
+      dim--;
+    }
+    if (dim < 0)
+    {
+      break;
+    }
+  }
+  check_design();
+}
+
+/**
+ * \brief    Build a Latin hypercube design from a specification file
+ * \details  Each line of the specification reads "name min max". Each range is cut in nb_samples strata, and
+ *           each stratum is sampled exactly once per parameter.
+ * \param    std::string filename
+ * \param    int nb_samples
+ * \param    unsigned long int seed
+ * \return   \e void
+ */
+void Sweep::build_latin_hypercube_design( std::string filename, int nb_samples, unsigned long int seed )
+{
+  assert(nb_samples > 0);
+  std::ifstream file(filename, std::ios::in);
+  if (!file)
+  {
+    std::cout << "Error: unable to open Latin hypercube specification file " << filename << ".\n";
+    exit(EXIT_FAILURE);
+  }
+  _design_names.clear();
+  _design_values.clear();
+  _design_values.resize(nb_samples);
+  Prng        prng(seed);
+  std::string line;
+  while(getline(file, line))
+  {
+    std::stringstream flux(line);
+    std::string       name = "";
+    double            min  = 0.0;
+    double            max  = 0.0;
+    if (!(flux >> name) || name[0] == '#')
+    {
+      continue;
+    }
+    if (!(flux >> min >> max))
+    {
+      std::cout << "Error: wrong Latin hypercube specification line \"" << line << "\".\n";
+      exit(EXIT_FAILURE);
+    }
+    add_design_name(name);
+    std::vector<int> strata(nb_samples, 0);
+    for (int i = 0; i < nb_samples; i++)
+    {
+      strata[i] = i;
+    }
+    for (int i = nb_samples-1; i > 0; i--)
+    {
+      int j     = prng.uniform(0, i);
+      int tmp   = strata[i];
+      strata[i] = strata[j];
+      strata[j] = tmp;
+    }
+    for (int i = 0; i < nb_samples; i++)
+    {
+      double u = ((double)strata[i]+prng.uniform())/(double)nb_samples;
+      _design_values[i].push_back(format_value(min+(max-min)*u));
+    }
+  }
+  file.close();
+  if (_design_names.size() == 0)
+  {
+    _design_values.clear();
+  }
+  check_design();
+}
+
+/**
+ * \brief    Write the design in a CSV file
+ * \details  The file can be reloaded with load_design()
+ * \param    std::string filename
+ * \return   \e void
+ */
+void Sweep::write_design( std::string filename )
+{
+  std::ofstream file(filename, std::ios::out | std::ios::trunc);
+  for (size_t i = 0; i < _design_names.size(); i++)
+  {
+    file << (i > 0 ? "," : "") << _design_names[i];
+  }
+  file << "\n";
+  for (size_t set = 0; set < _design_values.size(); set++)
+  {
+    for (size_t i = 0; i < _design_names.size(); i++)
+    {
+      file << (i > 0 ? "," : "") << _design_values[set][i];
+    }
+    file << "\n";
+  }
+  file.close();
+}
+
+/**
+ * \brief    Evaluate all the parameter sets and write the results table
+ * \details  Sets already present in the results table (from an interrupted sweep) are skipped.
+ *           Returns the number of sets evaluated during this call.
+ * \param    std::string filename
+ * \return   \e int
+ */
+int Sweep::run( std::string filename )
+{
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Restore the previous results, if any  */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  _done.assign(_design_values.size(), false);
+  int nb_restored = restore_checkpoint(filename);
+
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Open the results table                */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  _output.open(filename, std::ios::out | std::ios::app);
+
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Evaluate the remaining sets           */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  _next_set = 0;
+  std::vector<std::thread> workers;
+  for (int i = 0; i < _nb_threads; i++)
+  {
+    workers.push_back(std::thread(&Sweep::run_worker, this));
+  }
+  for (size_t i = 0; i < workers.size(); i++)
+  {
+    workers[i].join();
+  }
+  _output.close();
+  return get_number_of_sets()-nb_restored;
+}
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Add a parameter name to the design
+ * \details  Input files, the number of repetitions, the state layout and the node order define the loaded
+ *           graph and cannot be swept
+ * \param    std::string name
+ * \return   \e void
+ */
+void Sweep::add_design_name( std::string name )
+{
+  if (name == "map" || name == "network" || name == "sample" || name == "reps" || name == "layout" || name == "order")
+  {
+    std::cout << "Error: parameter " << name << " cannot be swept.\n";
+    exit(EXIT_FAILURE);
+  }
+  for (size_t i = 0; i < _design_names.size(); i++)
+  {
+    if (_design_names[i] == name)
+    {
+      std::cout << "Error: parameter " << name << " is defined twice in the design.\n";
+      exit(EXIT_FAILURE);
+    }
+  }
+  _design_names.push_back(name);
+}
+
+/**
+ * \brief    Check that every value of the design is valid
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void Sweep::check_design( void )
+{
+  Parameters* parameters = new Parameters();
+  for (size_t set = 0; set < _design_values.size(); set++)
+  {
+    for (size_t i = 0; i < _design_names.size(); i++)
+    {
+      if (!parameters->set_parameter(_design_names[i], _design_values[set][i]))
+      {
+        std::cout << "Error: wrong value " << _design_values[set][i] << " for parameter " << _design_names[i] << " (set " << set+1 << ").\n";
+        exit(EXIT_FAILURE);
+      }
+    }
+  }
+  delete parameters;
+  parameters = NULL;
+}
+
+/**
+ * \brief    Apply the base parameters, then the values of a parameter set
+ * \details  The seed is applied again for each set, so results do not depend on the evaluation order
+ * \param    Parameters* parameters
+ * \param    int set
+ * \return   \e void
+ */
+void Sweep::apply_set( Parameters* parameters, int set )
+{
+  for (size_t i = 0; i < _base_names.size(); i++)
+  {
+    parameters->set_parameter(_base_names[i], _base_values[i]);
+  }
+  for (size_t i = 0; i < _design_names.size(); i++)
+  {
+    parameters->set_parameter(_design_names[i], _design_values[set][i]);
+  }
+  parameters->set_save_outputs(false);
+  parameters->set_save_all_states(false);
+  parameters->set_save_history(false);
+}
+
+/**
+ * \brief    Restore the results of an interrupted sweep
+ * \details  Complete lines are kept and their sets marked as done. A truncated last line is dropped.
+ *           A line whose parameter values differ from the design is an error.
+ *           The results table is rewritten with a header if needed. Returns the number of restored sets.
+ * \param    std::string filename
+ * \return   \e int
+ */
+int Sweep::restore_checkpoint( std::string filename )
+{
+  std::stringstream header;
+  header << "set";
+  if (_labels.size() > 0)
+  {
+    header << " " << _label_name;
+  }
+  for (size_t i = 0; i < _design_names.size(); i++)
+  {
+    header << " " << _design_names[i];
+  }
+  header << " L empty_L max_L empty_score score";
+  size_t nb_fields = _design_names.size()+(_labels.size() > 0 ? 7 : 6);
+
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Read the complete lines of the table  */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::vector<std::string> kept;
+  std::ifstream            file(filename, std::ios::in);
+  if (file)
+  {
+    std::stringstream content;
+    content << file.rdbuf();
+    file.close();
+    std::string text  = content.str();
+    size_t      start = 0;
+    size_t      end   = text.find('\n');
+    bool        first = true;
+    while (end != std::string::npos)
+    {
+      std::string line = text.substr(start, end-start);
+      if (first)
+      {
+        if (line != header.str())
+        {
+          std::cout << "Error: results table " << filename << " does not match the design.\n";
+          exit(EXIT_FAILURE);
+        }
+        first = false;
+      }
+      else
+      {
+        std::stringstream        flux(line);
+        std::vector<std::string> fields;
+        std::string              field;
+        while (flux >> field)
+        {
+          fields.push_back(field);
+        }
+        int set = (fields.size() == nb_fields ? atoi(fields[0].c_str())-1 : -1);
+        if (set >= 0 && set < get_number_of_sets() && !_done[set])
+        {
+          size_t first_value = (_labels.size() > 0 ? 2 : 1);
+          bool   same_set    = (_labels.size() == 0 || fields[1] == _labels[set]);
+          for (size_t i = 0; i < _design_names.size() && same_set; i++)
+          {
+            same_set = (fields[first_value+i] == _design_values[set][i]);
+          }
+          if (!same_set)
+          {
+            std::cout << "Error: results table " << filename << " was written for another design (set " << set+1 << " has other parameter values).\n";
+            exit(EXIT_FAILURE);
+          }
+          _done[set] = true;
+          kept.push_back(line);
+        }
+      }
+      start = end+1;
+      end   = text.find('\n', start);
+    }
+  }
+
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Rewrite the table                     */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  std::ofstream output(filename, std::ios::out | std::ios::trunc);
+  output << header.str() << "\n";
+  for (size_t i = 0; i < kept.size(); i++)
+  {
+    output << kept[i] << "\n";
+  }
+  output.close();
+  return (int)kept.size();
+}
+
+/**
+ * \brief    Worker thread loop
+ * \details  Each worker loads the graph once, then reinitializes it for every parameter set it evaluates
+ * \param    void
+ * \return   \e void
+ */
+void Sweep::run_worker( void )
+{
+  Parameters* parameters = NULL;
+  Simulation* simulation = NULL;
+  while (true)
+  {
+    /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+    /* 1) Get the next set to evaluate          */
+    /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+    int set = -1;
+    _mutex.lock();
+    while (_next_set < get_number_of_sets() && _done[_next_set])
+    {
+      _next_set++;
+    }
+    if (_next_set < get_number_of_sets())
+    {
+      set = _next_set;
+      _next_set++;
+    }
+    _mutex.unlock();
+    if (set == -1)
+    {
+      break;
+    }
+
+    /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+    /* 2) Run the simulation                    */
+    /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+    MORIS_TRACE_BEGIN("simulation");
+    if (parameters == NULL)
+    {
+      parameters = new Parameters();
+      apply_set(parameters, set);
+      simulation = new Simulation(parameters);
+    }
+    else
+    {
+      apply_set(parameters, set);
+      simulation->reinitialize();
+    }
+    while (simulation->get_iteration() < parameters->get_iterations())
+    {
+      simulation->compute_next_iteration();
+    }
+    simulation->compute_score();
+    MORIS_TRACE_END("simulation", "set", set+1);
+
+    /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+    /* 3) Write the results                     */
+    /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+    std::stringstream line;
+    line << set+1;
+    if (_labels.size() > 0)
+    {
+      line << " " << _labels[set];
+    }
+    for (size_t i = 0; i < _design_names.size(); i++)
+    {
+      line << " " << _design_values[set][i];
+    }
+    line << " " << format_result(simulation->get_total_log_likelihood());
+    line << " " << format_result(simulation->get_total_log_empty_likelihood());
+    line << " " << format_result(simulation->get_total_log_maximum_likelihood());
+    line << " " << format_result(simulation->get_empty_score());
+    line << " " << format_result(simulation->get_score()) << "\n";
+    _mutex.lock();
+    _output << line.str();
+    _output.flush();
+    _done[set] = true;
+    _mutex.unlock();
+  }
+  delete simulation;
+  simulation = NULL;
+  delete parameters;
+  parameters = NULL;
+}
+
+/**
+ * \brief    Format a generated parameter value
+ * \details  --
+ * \param    double value
+ * \return   \e std::string
+ */
+std::string Sweep::format_value( double value )
+{
+  std::stringstream flux;
+  flux.precision(15);
+  flux << value;
+  return flux.str();
+}
+
+/**
+ * \brief    Format a result of the results table
+ * \details  Uses the shortest representation that reads back exactly, as the other output files
+ * \param    double value
+ * \return   \e std::string
+ */
+std::string Sweep::format_result( double value )
+{
+  char buffer[TextWriter::MAX_LENGTH];
+  size_t length = TextWriter::format_double(value, buffer);
+  return std::string(buffer, length);
+}
@@ -0,0 +1,189 @@
+/**
+ * \file      Sweep.h
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     Sweep class declaration
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef __MoRIS__Sweep__
+#define __MoRIS__Sweep__
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <cstring>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "Enums.h"
+#include "Prng.h"
+#include "Parameters.h"
+#include "Simulation.h"
+
+
+class Sweep
+{
+
+public:
+
+  /*----------------------------
+   * CONSTRUCTORS
+   *----------------------------*/
+  Sweep( void ) = delete;
+  Sweep( std::vector<std::string> base_names, std::vector<std::string> base_values, int nb_threads );
+  Sweep( const Sweep& sweep ) = delete;
+
+  /*----------------------------
+   * DESTRUCTORS
+   *----------------------------*/
+  ~Sweep( void );
+
+  /*----------------------------
+   * GETTERS
+   *----------------------------*/
+  inline int  get_number_of_sets( void ) const;
+  inline int  get_number_of_threads( void ) const;
+  inline bool is_defined( std::string name ) const;
+
+  /*----------------------------
+   * SETTERS
+   *----------------------------*/
+  Sweep& operator=(const Sweep&) = delete;
+
+  /*----------------------------
+   * PUBLIC METHODS
+   *----------------------------*/
+  void set_design( std::vector<std::string> names, std::vector< std::vector<std::string> > values );
+  void set_labels( std::string name, std::vector<std::string> labels );
+  void load_design( std::string filename );
+  void build_grid_design( std::string filename );
+  void build_latin_hypercube_design( std::string filename, int nb_samples, unsigned long int seed );
+  void write_design( std::string filename );
+  int  run( std::string filename );
+
+  /*----------------------------
+   * PUBLIC ATTRIBUTES
+   *----------------------------*/
+
+protected:
+
+  /*----------------------------
+   * PROTECTED METHODS
+   *----------------------------*/
+  void        add_design_name( std::string name );
+  void        check_design( void );
+  void        apply_set( Parameters* parameters, int set );
+  int         restore_checkpoint( std::string filename );
+  void        run_worker( void );
+  std::string format_value( double value );
+  std::string format_result( double value );
+
+  /*----------------------------
+   * PROTECTED ATTRIBUTES
+   *----------------------------*/
+
+  /*--------------------------------------- BASE PARAMETERS */
+
+  std::vector<std::string> _base_names;  /*!< Names of the parameters shared by all the sets  */
+  std::vector<std::string> _base_values; /*!< Values of the parameters shared by all the sets */
+  int                      _nb_threads;  /*!< Number of worker threads                        */
+
+  /*--------------------------------------- DESIGN */
+
+  std::vector<std::string>                _design_names;  /*!< Names of the swept parameters   */
+  std::vector< std::vector<std::string> > _design_values; /*!< Parameter values of each set    */
+  std::string                             _label_name;    /*!< Name of the label column        */
+  std::vector<std::string>                _labels;        /*!< Label of each set (optional)    */
+
+  /*--------------------------------------- EVALUATION */
+
+  std::vector<bool> _done;     /*!< Sets already evaluated           */
+  int               _next_set; /*!< Next set to hand to a worker     */
+  std::ofstream     _output;   /*!< Results table                    */
+  std::mutex        _mutex;    /*!< Protects the queue and the table */
+
+};
+
+
+/*----------------------------
+ * GETTERS
+ *----------------------------*/
+
+/**
+ * \brief    Get the number of parameter sets in the design
+ * \details  --
+ * \param    void
+ * \return   \e int
+ */
+inline int Sweep::get_number_of_sets( void ) const
+{
+  return (int)_design_values.size();
+}
+
+/**
+ * \brief    Get the number of worker threads
+ * \details  --
+ * \param    void
+ * \return   \e int
+ */
+inline int Sweep::get_number_of_threads( void ) const
+{
+  return _nb_threads;
+}
+
+/**
+ * \brief    Check if a parameter is defined, either by the base parameters or by the design
+ * \details  --
+ * \param    std::string name
+ * \return   \e bool
+ */
+inline bool Sweep::is_defined( std::string name ) const
+{
+  for (size_t i = 0; i < _base_names.size(); i++)
+  {
+    if (_base_names[i] == name)
+    {
+      return true;
+    }
+  }
+  for (size_t i = 0; i < _design_names.size(); i++)
+  {
+    if (_design_names[i] == name)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*----------------------------
+ * SETTERS
+ *----------------------------*/
+
+
+#endif /* defined(__MoRIS__Sweep__) */
@@ -0,0 +1,484 @@
+/**
+ * \file      TextWriter.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     TextWriter class definition
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "TextWriter.h"
+
+
+/*----------------------------
+ * CONSTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Default constructor
+ * \details  No file is open
+ * \param    void
+ * \return   \e void
+ */
+TextWriter::TextWriter( void )
+{
+  _buffer.resize(BUFFER_SIZE);
+  _size = 0;
+}
+
+/**
+ * \brief    Constructor
+ * \details  The file is created (or truncated)
+ * \param    std::string filename
+ * \return   \e void
+ */
+TextWriter::TextWriter( std::string filename )
+{
+  _buffer.resize(BUFFER_SIZE);
+  _size = 0;
+  open(filename);
+}
+
+/*----------------------------
+ * DESTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Destructor
+ * \details  Buffered text is written before the file is closed
+ * \param    void
+ * \return   \e void
+ */
+TextWriter::~TextWriter( void )
+{
+  close();
+  _buffer.clear();
+}
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Open a file
+ * \details  The file is created (or truncated). A previously open file is closed.
+ * \param    std::string filename
+ * \return   \e void
+ */
+void TextWriter::open( std::string filename )
+{
+  close();
+  _file.open(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+}
+
+/**
+ * \brief    Open a file at its end
+ * \details  The file is created if it does not exist. A previously open file is closed.
+ * \param    std::string filename
+ * \return   \e void
+ */
+void TextWriter::append( std::string filename )
+{
+  close();
+  _file.open(filename, std::ios::out | std::ios::app | std::ios::binary);
+}
+
+/**
+ * \brief    Close the file
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void TextWriter::close( void )
+{
+  if (_file.is_open())
+  {
+    flush();
+    _file.close();
+  }
+  _size = 0;
+}
+
+/**
+ * \brief    Write the buffered text to the file
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+void TextWriter::flush( void )
+{
+  if (_size > 0 && _file.is_open())
+  {
+    MORIS_TRACE_BEGIN("flush");
+    _file.write(_buffer.data(), _size);
+    _file.flush();
+    MORIS_TRACE_END("flush", "bytes", (int64_t)_size);
+  }
+  _size = 0;
+}
+
+/**
+ * \brief    Format an integer
+ * \details  Returns the number of written characters
+ * \param    long long value
+ * \param    char* buffer
+ * \return   \e size_t
+ */
+size_t TextWriter::format_integer( long long value, char* buffer )
+{
+  char               digits[20];
+  size_t             nb_digits = 0;
+  size_t             length    = 0;
+  unsigned long long absolute  = (value < 0 ? 0ULL-(unsigned long long)value : (unsigned long long)value);
+  do
+  {
+    digits[nb_digits++] = (char)('0'+absolute%10);
+    absolute           /= 10;
+  }
+  while (absolute > 0);
+  if (value < 0)
+  {
+    buffer[length++] = '-';
+  }
+  while (nb_digits > 0)
+  {
+    buffer[length++] = digits[--nb_digits];
+  }
+  return length;
+}
+
+/**
+ * \brief    Format a double with the shortest representation that reads back exactly
+ * \details  The layout follows the printf %g conversion (as std::ostream does) with the smallest precision
+ *           (15, 16 or 17 significant digits) for which the value reads back exactly, trailing zeros removed.
+ *           Integers below 1e15 take a fast path. Returns the number of written characters.
+ * \param    double value
+ * \param    char* buffer
+ * \return   \e size_t
+ */
+size_t TextWriter::format_double( double value, char* buffer )
+{
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 1) Integers, zeros and non-finite */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  if (value != 0.0 && fabs(value) < 1e15 && value == (double)(long long)value)
+  {
+    return format_integer((long long)value, buffer);
+  }
+  if (value == 0.0 || !std::isfinite(value))
+  {
+    return (size_t)snprintf(buffer, MAX_LENGTH, "%g", value);
+  }
+  size_t length = 0;
+  if (format_double_fast(value, buffer, length))
+  {
+    return length;
+  }
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 2) Get the first 17 digits        */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  char scientific[MAX_LENGTH];
+  snprintf(scientific, MAX_LENGTH, "%.16e", value);
+  bool negative = (scientific[0] == '-');
+  const char* mantissa = scientific+(negative ? 1 : 0);
+  char digits[17];
+  digits[0] = mantissa[0];
+  memcpy(digits+1, mantissa+2, 16);
+  int exponent = atoi(mantissa+19);
+  
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  /* 3) Find the shortest precision    */
+  /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+  for (int precision = 15; precision < 17; precision++)
+  {
+    char   rounded[17];
+    int    rounded_exponent = exponent;
+    size_t nb_digits        = round_digits(digits, precision, rounded, rounded_exponent);
+    size_t length           = 0;
+    if (nb_digits == 0)
+    {
+      /* Ties can not be rounded from 17 digits */
+      length = (size_t)snprintf(buffer, MAX_LENGTH, "%.*g", precision, value);
+    }
+    else
+    {
+      length = write_digits(negative, rounded, nb_digits, rounded_exponent, precision, buffer);
+    }
+    buffer[length] = '\0';
+    if (strtod(buffer, NULL) == value)
+    {
+      return length;
+    }
+  }
+  size_t nb_digits = 17;
+  while (nb_digits > 1 && digits[nb_digits-1] == '0')
+  {
+    nb_digits--;
+  }
+  return write_digits(negative, digits, nb_digits, exponent, 17, buffer);
+}
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Format a double without printf when possible
+ * \details  The value is scaled to precision digits with extended precision arithmetic, and the rounded digits
+ *           are checked to read back exactly with a single correctly rounded double operation (exact when the
+ *           digits fit in 53 bits and the power of ten is exact). Returns false when the result can not be
+ *           guaranteed (no extended precision, rounding too close to a tie, or out of range), so that the
+ *           caller falls back to printf.
+ * \param    double value
+ * \param    char* buffer
+ * \param    size_t& length
+ * \return   \e bool
+ */
+bool TextWriter::format_double_fast( double value, char* buffer, size_t& length )
+{
+  if (std::numeric_limits<long double>::digits < 64)
+  {
+    return false;
+  }
+  /* Powers of ten, exact up to 1e27 in extended precision and 1e22 in double precision */
+  static long double powers[28];
+  static double      exact_powers[23];
+  static const bool  initialized = []()
+  {
+    powers[0]       = 1.0L;
+    exact_powers[0] = 1.0;
+    for (int i = 1; i < 28; i++)
+    {
+      powers[i] = powers[i-1]*10.0L;
+    }
+    for (int i = 1; i < 23; i++)
+    {
+      exact_powers[i] = exact_powers[i-1]*10.0;
+    }
+    return true;
+  }();
+  (void)initialized;
+  double absolute = fabs(value);
+  int    exponent = (int)floor(log10(absolute));
+  for (int precision = 15; precision <= 17; precision++)
+  {
+    /*----------------------------------------*/
+    /* 1) Scale the value to precision digits */
+    /*----------------------------------------*/
+    long double scaled = 0.0L;
+    long double error  = 0.0L;
+    int         k      = 0;
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+      k = precision-1-exponent;
+      if (k > 54 || k < -54)
+      {
+        return false;
+      }
+      int         first  = (k < 0 ? -k : k);
+      long double factor = (first > 27 ? powers[27]*powers[first-27] : powers[first]);
+      scaled = (k >= 0 ? (long double)absolute*factor : (long double)absolute/factor);
+      error  = scaled*(first > 27 ? 2.2e-19L : 1.1e-19L);
+      if (scaled >= powers[precision])
+      {
+        exponent++;
+      }
+      else if (scaled < powers[precision-1])
+      {
+        exponent--;
+      }
+      else
+      {
+        break;
+      }
+    }
+    if (scaled >= powers[precision] || scaled < powers[precision-1])
+    {
+      return false;
+    }
+    
+    /*----------------------------------------*/
+    /* 2) Round, unless too close to a tie    */
+    /*----------------------------------------*/
+    long double integer  = floorl(scaled);
+    long double fraction = scaled-integer;
+    if (fabsl(fraction-0.5L) <= error)
+    {
+      return false;
+    }
+    unsigned long long digits_value   = (unsigned long long)integer+(fraction > 0.5L ? 1ULL : 0ULL);
+    int                digits_exponent = exponent;
+    if ((long double)digits_value == powers[precision])
+    {
+      digits_value /= 10;
+      digits_exponent++;
+    }
+    
+    /*----------------------------------------*/
+    /* 3) Write the digits                    */
+    /*----------------------------------------*/
+    char   digits[20];
+    size_t nb_digits = format_integer((long long)digits_value, digits);
+    while (nb_digits > 1 && digits[nb_digits-1] == '0')
+    {
+      nb_digits--;
+    }
+    length = write_digits(value < 0.0, digits, nb_digits, digits_exponent, precision, buffer);
+    
+    /*----------------------------------------*/
+    /* 4) Check that the digits read back     */
+    /*----------------------------------------*/
+    if (precision == 17)
+    {
+      return true;
+    }
+    int scale = precision-1-digits_exponent;
+    if (digits_value <= 9007199254740992ULL && scale <= 22 && scale >= -22)
+    {
+      double back = (scale >= 0 ? (double)digits_value/exact_powers[scale] : (double)digits_value*exact_powers[-scale]);
+      if (back == absolute)
+      {
+        return true;
+      }
+    }
+    else
+    {
+      buffer[length] = '\0';
+      if (strtod(buffer, NULL) == value)
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * \brief    Round 17 significant digits to a given precision
+ * \details  Trailing zeros are removed. Returns the number of digits, or 0 if the dropped digits are an
+ *           exact tie (the correct rounding then depends on the digits beyond the 17th).
+ * \param    const char* digits
+ * \param    int precision
+ * \param    char* rounded
+ * \param    int& exponent
+ * \return   \e size_t
+ */
+size_t TextWriter::round_digits( const char* digits, int precision, char* rounded, int& exponent )
+{
+  bool tie = (digits[precision] == '5');
+  for (int i = precision+1; i < 17 && tie; i++)
+  {
+    tie = (digits[i] == '0');
+  }
+  if (tie)
+  {
+    return 0;
+  }
+  memcpy(rounded, digits, precision);
+  if (digits[precision] >= '5')
+  {
+    int i = precision-1;
+    while (i >= 0 && rounded[i] == '9')
+    {
+      rounded[i--] = '0';
+    }
+    if (i >= 0)
+    {
+      rounded[i]++;
+    }
+    else
+    {
+      rounded[0] = '1';
+      exponent++;
+    }
+  }
+  size_t nb_digits = (size_t)precision;
+  while (nb_digits > 1 && rounded[nb_digits-1] == '0')
+  {
+    nb_digits--;
+  }
+  return nb_digits;
+}
+
+/**
+ * \brief    Write significant digits in the printf %g layout
+ * \details  Returns the number of written characters
+ * \param    bool negative
+ * \param    const char* digits
+ * \param    size_t nb_digits
+ * \param    int exponent
+ * \param    int precision
+ * \param    char* buffer
+ * \return   \e size_t
+ */
+size_t TextWriter::write_digits( bool negative, const char* digits, size_t nb_digits, int exponent, int precision, char* buffer )
+{
+  size_t length = 0;
+  if (negative)
+  {
+    buffer[length++] = '-';
+  }
+  if (exponent < -4 || exponent >= precision)
+  {
+    buffer[length++] = digits[0];
+    if (nb_digits > 1)
+    {
+      buffer[length++] = '.';
+      memcpy(buffer+length, digits+1, nb_digits-1);
+      length += nb_digits-1;
+    }
+    buffer[length++] = 'e';
+    buffer[length++] = (exponent < 0 ? '-' : '+');
+    int absolute = (exponent < 0 ? -exponent : exponent);
+    if (absolute < 10)
+    {
+      buffer[length++] = '0';
+    }
+    length += format_integer(absolute, buffer+length);
+  }
+  else if (exponent < 0)
+  {
+    buffer[length++] = '0';
+    buffer[length++] = '.';
+    for (int i = -1; i > exponent; i--)
+    {
+      buffer[length++] = '0';
+    }
+    memcpy(buffer+length, digits, nb_digits);
+    length += nb_digits;
+  }
+  else
+  {
+    for (int i = 0; i <= exponent; i++)
+    {
+      buffer[length++] = ((size_t)i < nb_digits ? digits[i] : '0');
+    }
+    if ((size_t)exponent+1 < nb_digits)
+    {
+      buffer[length++] = '.';
+      memcpy(buffer+length, digits+exponent+1, nb_digits-exponent-1);
+      length += nb_digits-exponent-1;
+    }
+  }
+  return length;
+}
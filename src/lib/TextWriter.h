@@ -0,0 +1,280 @@
+/**
+ * \file      TextWriter.h
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     TextWriter class declaration
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef __MoRIS__TextWriter__
+#define __MoRIS__TextWriter__
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "Tracer.h"
+
+
+class TextWriter
+{
+  
+public:
+  
+  /*----------------------------
+   * CONSTRUCTORS
+   *----------------------------*/
+  TextWriter( void );
+  TextWriter( std::string filename );
+  TextWriter( const TextWriter& writer ) = delete;
+  
+  /*----------------------------
+   * DESTRUCTORS
+   *----------------------------*/
+  ~TextWriter( void );
+  
+  /*----------------------------
+   * GETTERS
+   *----------------------------*/
+  inline bool is_open( void ) const;
+  
+  /*----------------------------
+   * SETTERS
+   *----------------------------*/
+  TextWriter& operator=(const TextWriter&) = delete;
+  
+  /*----------------------------
+   * PUBLIC METHODS
+   *----------------------------*/
+  void open( std::string filename );
+  void append( std::string filename );
+  void close( void );
+  void flush( void );
+  
+  inline TextWriter& operator<<( const char* text );
+  inline TextWriter& operator<<( const std::string& text );
+  inline TextWriter& operator<<( char character );
+  inline TextWriter& operator<<( bool value );
+  inline TextWriter& operator<<( int value );
+  inline TextWriter& operator<<( long value );
+  inline TextWriter& operator<<( unsigned long value );
+  inline TextWriter& operator<<( double value );
+  
+  static size_t format_integer( long long value, char* buffer );
+  static size_t format_double( double value, char* buffer );
+  
+  /*----------------------------
+   * PUBLIC ATTRIBUTES
+   *----------------------------*/
+  static const size_t BUFFER_SIZE = 1048576; /*!< Output buffer size                    */
+  static const size_t MAX_LENGTH  = 32;      /*!< Maximal length of a formatted number */
+  
+protected:
+  
+  /*----------------------------
+   * PROTECTED METHODS
+   *----------------------------*/
+  inline void reserve( size_t length );
+  
+  static bool   format_double_fast( double value, char* buffer, size_t& length );
+  static size_t round_digits( const char* digits, int precision, char* rounded, int& exponent );
+  static size_t write_digits( bool negative, const char* digits, size_t nb_digits, int exponent, int precision, char* buffer );
+  
+  /*----------------------------
+   * PROTECTED ATTRIBUTES
+   *----------------------------*/
+  std::ofstream     _file;   /*!< Output file               */
+  std::vector<char> _buffer; /*!< Output buffer             */
+  size_t            _size;   /*!< Number of buffered bytes  */
+  
+};
+
+
+/*----------------------------
+ * GETTERS
+ *----------------------------*/
+
+/**
+ * \brief    Check if the file is open
+ * \details  --
+ * \param    void
+ * \return   \e bool
+ */
+inline bool TextWriter::is_open( void ) const
+{
+  return _file.is_open();
+}
+
+/*----------------------------
+ * SETTERS
+ *----------------------------*/
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Write a C string
+ * \details  --
+ * \param    const char* text
+ * \return   \e TextWriter&
+ */
+inline TextWriter& TextWriter::operator<<( const char* text )
+{
+  size_t length = strlen(text);
+  reserve(length);
+  memcpy(&_buffer[_size], text, length);
+  _size += length;
+  return *this;
+}
+
+/**
+ * \brief    Write a string
+ * \details  --
+ * \param    const std::string& text
+ * \return   \e TextWriter&
+ */
+inline TextWriter& TextWriter::operator<<( const std::string& text )
+{
+  reserve(text.size());
+  memcpy(&_buffer[_size], text.data(), text.size());
+  _size += text.size();
+  return *this;
+}
+
+/**
+ * \brief    Write a character
+ * \details  --
+ * \param    char character
+ * \return   \e TextWriter&
+ */
+inline TextWriter& TextWriter::operator<<( char character )
+{
+  reserve(1);
+  _buffer[_size++] = character;
+  return *this;
+}
+
+/**
+ * \brief    Write a boolean (as 0 or 1)
+ * \details  --
+ * \param    bool value
+ * \return   \e TextWriter&
+ */
+inline TextWriter& TextWriter::operator<<( bool value )
+{
+  reserve(1);
+  _buffer[_size++] = (value ? '1' : '0');
+  return *this;
+}
+
+/**
+ * \brief    Write an integer
+ * \details  --
+ * \param    int value
+ * \return   \e TextWriter&
+ */
+inline TextWriter& TextWriter::operator<<( int value )
+{
+  reserve(MAX_LENGTH);
+  _size += format_integer(value, &_buffer[_size]);
+  return *this;
+}
+
+/**
+ * \brief    Write a long integer
+ * \details  --
+ * \param    long value
+ * \return   \e TextWriter&
+ */
+inline TextWriter& TextWriter::operator<<( long value )
+{
+  reserve(MAX_LENGTH);
+  _size += format_integer(value, &_buffer[_size]);
+  return *this;
+}
+
+/**
+ * \brief    Write an unsigned long integer
+ * \details  --
+ * \param    unsigned long value
+ * \return   \e TextWriter&
+ */
+inline TextWriter& TextWriter::operator<<( unsigned long value )
+{
+  reserve(MAX_LENGTH);
+  if (value <= 9223372036854775807UL)
+  {
+    _size += format_integer((long long)value, &_buffer[_size]);
+  }
+  else
+  {
+    _size += format_integer((long long)(value/10), &_buffer[_size]);
+    _buffer[_size++] = (char)('0'+value%10);
+  }
+  return *this;
+}
+
+/**
+ * \brief    Write a double with the shortest representation that reads back exactly
+ * \details  --
+ * \param    double value
+ * \return   \e TextWriter&
+ */
+inline TextWriter& TextWriter::operator<<( double value )
+{
+  reserve(MAX_LENGTH);
+  _size += format_double(value, &_buffer[_size]);
+  return *this;
+}
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Make room for length bytes in the buffer
+ * \details  The buffer is written to the file when full
+ * \param    size_t length
+ * \return   \e void
+ */
+inline void TextWriter::reserve( size_t length )
+{
+  if (_size+length > _buffer.size())
+  {
+    flush();
+    if (length > _buffer.size())
+    {
+      _buffer.resize(length);
+    }
+  }
+}
+
+
+#endif /* defined(__MoRIS__TextWriter__) */
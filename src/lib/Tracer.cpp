@@ -0,0 +1,159 @@
+/**
+ * \file      Tracer.cpp
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     Tracer class definition
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "Tracer.h"
+
+#ifdef MORIS_TRACING
+
+thread_local Tracer*                  Tracer::_current = NULL;
+std::vector<Tracer*>                  Tracer::_tracers;
+std::chrono::steady_clock::time_point Tracer::_start = std::chrono::steady_clock::now();
+std::mutex                            Tracer::_mutex;
+
+
+/*----------------------------
+ * CONSTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Constructor
+ * \details  Ring buffer of a thread. Its capacity is given by the MORIS_TRACE_EVENTS environment variable
+ *           (default: 131072 events by thread).
+ * \param    void
+ * \return   \e void
+ */
+Tracer::Tracer( void )
+{
+  const char* capacity = getenv("MORIS_TRACE_EVENTS");
+  long        size     = (capacity != NULL ? atol(capacity) : 0);
+  _events.resize((size_t)(size > 0 ? size : 131072));
+  _head   = 0;
+  _thread = 0;
+}
+
+/*----------------------------
+ * DESTRUCTORS
+ *----------------------------*/
+
+/**
+ * \brief    Destructor
+ * \details  --
+ * \param    void
+ * \return   \e void
+ */
+Tracer::~Tracer( void )
+{
+  _events.clear();
+}
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Write the Chrome trace-event JSON file
+ * \details  Called at exit. The trace is written in the file given by the MORIS_TRACE_FILE environment variable
+ *           (default: trace.json), and can be opened in chrome://tracing or https://ui.perfetto.dev. When a ring
+ *           buffer is full, its oldest events are lost: spans whose beginning was overwritten are dropped.
+ * \param    void
+ * \return   \e void
+ */
+void Tracer::write_trace( void )
+{
+  const char* filename = getenv("MORIS_TRACE_FILE");
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::ofstream file((filename != NULL ? filename : "trace.json"), std::ios::out | std::ios::trunc);
+  if (!file)
+  {
+    std::cerr << "Error: unable to write the trace.\n";
+    return;
+  }
+  file.setf(std::ios::fixed);
+  file.precision(3);
+  file << "{\"traceEvents\": [\n";
+  bool     first   = true;
+  uint64_t dropped = 0;
+  for (size_t t = 0; t < _tracers.size(); t++)
+  {
+    Tracer*  tracer = _tracers[t];
+    uint64_t head   = tracer->_head.load(std::memory_order_acquire);
+    uint64_t size   = (uint64_t)tracer->_events.size();
+    uint64_t oldest = (head > size ? head-size : 0);
+    int      depth  = 0;
+    dropped        += oldest;
+    file << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << tracer->_thread << ", \"args\": {\"name\": \"thread " << tracer->_thread << "\"}}";
+    first = false;
+    for (uint64_t i = oldest; i < head; i++)
+    {
+      const trace_event& event = tracer->_events[i%size];
+      if (event.phase == 'E' && depth == 0)
+      {
+        continue;
+      }
+      depth += (event.phase == 'B' ? 1 : -1);
+      file << ",\n{\"name\": \"" << event.name << "\", \"ph\": \"" << event.phase << "\", \"ts\": " << (double)event.time/1000.0 << ", \"pid\": 1, \"tid\": " << tracer->_thread;
+      if (event.arg_names[0] != NULL)
+      {
+        file << ", \"args\": {\"" << event.arg_names[0] << "\": " << event.arg_values[0];
+        if (event.arg_names[1] != NULL)
+        {
+          file << ", \"" << event.arg_names[1] << "\": " << event.arg_values[1];
+        }
+        file << "}";
+      }
+      file << "}";
+    }
+  }
+  file << "\n],\n\"displayTimeUnit\": \"ms\",\n\"otherData\": {\"dropped_events\": " << dropped << "}}\n";
+  file.close();
+}
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Create and register the ring buffer of the current thread
+ * \details  Called at the first event of each thread. The first registration also registers the trace to be
+ *           written at exit. Buffers are kept after their thread ends, until the trace is written.
+ * \param    void
+ * \return   \e Tracer*
+ */
+Tracer* Tracer::register_thread( void )
+{
+  static std::once_flag registered;
+  std::call_once(registered, []{ atexit(&Tracer::write_trace); });
+  Tracer* tracer = new Tracer();
+  std::lock_guard<std::mutex> lock(_mutex);
+  tracer->_thread = (int)_tracers.size();
+  _tracers.push_back(tracer);
+  _current = tracer;
+  return tracer;
+}
+
+#endif /* defined(MORIS_TRACING) */
@@ -0,0 +1,198 @@
+/**
+ * \file      Tracer.h
+ * \author    Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * \date      18-10-2026
+ * \copyright MoRIS. Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet. All rights reserved
+ * \license   This project is released under the GNU General Public License
+ * \brief     Tracer class declaration
+ */
+
+/****************************************************************************
+ * MoRIS (Model of Routes of Invasive Spread)
+ * Copyright © 2014-2024 Charles Rocabert, Jérôme M.W. Gippet, Serge Fenet
+ * Web: https://github.com/charlesrocabert/MoRIS
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#ifndef __MoRIS__Tracer__
+#define __MoRIS__Tracer__
+
+#ifdef MORIS_TRACING
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <stdlib.h>
+#include <assert.h>
+
+
+/**
+ * \brief   Trace event
+ * \details Names are string literals, so that recording an event never allocates
+ */
+struct trace_event
+{
+  const char* name;           /*!< Event name                             */
+  char        phase;          /*!< 'B' (begin) or 'E' (end)               */
+  uint64_t    time;           /*!< Time since the program start, in ns    */
+  const char* arg_names[2];   /*!< Argument names (NULL if unused)        */
+  int64_t     arg_values[2];  /*!< Argument values                        */
+};
+
+
+class Tracer
+{
+  
+public:
+  
+  /*----------------------------
+   * CONSTRUCTORS
+   *----------------------------*/
+  Tracer( void );
+  Tracer( const Tracer& tracer ) = delete;
+  
+  /*----------------------------
+   * DESTRUCTORS
+   *----------------------------*/
+  ~Tracer( void );
+  
+  /*----------------------------
+   * GETTERS
+   *----------------------------*/
+  
+  /*----------------------------
+   * SETTERS
+   *----------------------------*/
+  Tracer& operator=(const Tracer&) = delete;
+  
+  /*----------------------------
+   * PUBLIC METHODS
+   *----------------------------*/
+  static inline void begin( const char* name );
+  static inline void end( const char* name, const char* arg_name1 = NULL, int64_t arg_value1 = 0, const char* arg_name2 = NULL, int64_t arg_value2 = 0 );
+  static void        write_trace( void );
+  
+  /*----------------------------
+   * PUBLIC ATTRIBUTES
+   *----------------------------*/
+  
+protected:
+  
+  /*----------------------------
+   * PROTECTED METHODS
+   *----------------------------*/
+  static Tracer* register_thread( void );
+  inline void    record( const char* name, char phase, const char* arg_name1, int64_t arg_value1, const char* arg_name2, int64_t arg_value2 );
+  
+  /*----------------------------
+   * PROTECTED ATTRIBUTES
+   *----------------------------*/
+  
+  /*--------------------------------------- THREAD RING BUFFER */
+  
+  std::vector<trace_event> _events;   /*!< Ring buffer of the thread (the oldest events are overwritten) */
+  std::atomic<uint64_t>    _head;     /*!< Number of events recorded by the thread                       */
+  int                      _thread;   /*!< Trace thread identifier                                       */
+  
+  static thread_local Tracer* _current; /*!< Ring buffer of the current thread */
+  
+  /*--------------------------------------- REGISTERED BUFFERS */
+  
+  static std::vector<Tracer*>                  _tracers; /*!< Ring buffers of all the threads */
+  static std::chrono::steady_clock::time_point _start;   /*!< Program start                   */
+  static std::mutex                            _mutex;   /*!< Protects the registration       */
+  
+};
+
+
+/*----------------------------
+ * PUBLIC METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Record the beginning of a span on the current thread
+ * \details  --
+ * \param    const char* name
+ * \return   \e void
+ */
+inline void Tracer::begin( const char* name )
+{
+  Tracer* tracer = (_current != NULL ? _current : register_thread());
+  tracer->record(name, 'B', NULL, 0, NULL, 0);
+}
+
+/**
+ * \brief    Record the end of a span on the current thread, with up to two integer arguments
+ * \details  --
+ * \param    const char* name
+ * \param    const char* arg_name1
+ * \param    int64_t arg_value1
+ * \param    const char* arg_name2
+ * \param    int64_t arg_value2
+ * \return   \e void
+ */
+inline void Tracer::end( const char* name, const char* arg_name1, int64_t arg_value1, const char* arg_name2, int64_t arg_value2 )
+{
+  Tracer* tracer = (_current != NULL ? _current : register_thread());
+  tracer->record(name, 'E', arg_name1, arg_value1, arg_name2, arg_value2);
+}
+
+/*----------------------------
+ * PROTECTED METHODS
+ *----------------------------*/
+
+/**
+ * \brief    Record an event in the ring buffer of the thread
+ * \details  Only the owner thread writes in the buffer, so that no lock is needed. The head is published with
+ *           a release store, and read by write_trace() once the thread is done.
+ * \param    const char* name
+ * \param    char phase
+ * \param    const char* arg_name1
+ * \param    int64_t arg_value1
+ * \param    const char* arg_name2
+ * \param    int64_t arg_value2
+ * \return   \e void
+ */
+inline void Tracer::record( const char* name, char phase, const char* arg_name1, int64_t arg_value1, const char* arg_name2, int64_t arg_value2 )
+{
+  uint64_t     head  = _head.load(std::memory_order_relaxed);
+  trace_event& event = _events[head%_events.size()];
+  event.name          = name;
+  event.phase         = phase;
+  event.time          = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-_start).count();
+  event.arg_names[0]  = arg_name1;
+  event.arg_names[1]  = arg_name2;
+  event.arg_values[0] = arg_value1;
+  event.arg_values[1] = arg_value2;
+  _head.store(head+1, std::memory_order_release);
+}
+
+
+#define MORIS_TRACE_BEGIN(name) Tracer::begin(name)
+#define MORIS_TRACE_END(...)    Tracer::end(__VA_ARGS__)
+
+#else
+
+#define MORIS_TRACE_BEGIN(name)
+#define MORIS_TRACE_END(...)
+
+#endif /* defined(MORIS_TRACING) */
+
+#endif /* defined(__MoRIS__Tracer__) */